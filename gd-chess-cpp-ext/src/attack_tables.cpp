@@ -0,0 +1,163 @@
+#include "attack_tables.h"
+#include <mutex>
+
+namespace {
+    const short BISHOP_DIRECTIONS[4][2] = {{-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+    const short ROOK_DIRECTIONS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+    const uint64_t RANK_8 = 0x00000000000000FFULL; // row 0
+    const uint64_t RANK_1 = 0xFF00000000000000ULL; // row 7
+
+    // xorshift64* generator, seeded so the magics are the same on every load
+    struct magicRandom {
+        uint64_t state;
+
+        explicit magicRandom(uint64_t seed) : state(seed) {}
+
+        uint64_t next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 2685821657736338717ULL;
+        }
+
+        // magics with few set bits are found much faster
+        uint64_t sparse() {
+            return next() & next() & next();
+        }
+    };
+
+    AttackTables::sliderTables magicTables;
+    AttackTables::sliderTables pextTables;
+    std::once_flag magicTablesBuilt;
+    std::once_flag pextTablesBuilt;
+
+    // build the tables of the active backend when the shared library is loaded
+    const bool attackTablesReady = (AttackTables::getActiveTables(), true);
+}
+
+uint64_t AttackTables::slidingAttack(const short directions[4][2], short square, uint64_t occupied) {
+    uint64_t attacks = 0;
+    for (short i = 0; i < 4; ++i) {
+        short x = square % 8 + directions[i][0];
+        short y = square / 8 + directions[i][1];
+        while (x >= 0 && x < 8 && y >= 0 && y < 8) {
+            uint64_t target = 1ULL << (y * 8 + x);
+            attacks |= target;
+            if (occupied & target) {
+                break; // stop at the first blocker, it can still be captured
+            }
+            x += directions[i][0];
+            y += directions[i][1];
+        }
+    }
+    return attacks;
+}
+
+void AttackTables::initMagics(const short directions[4][2], uint64_t table[], magicEntry magics[]) {
+    uint64_t occupancy[4096];
+    uint64_t reference[4096];
+    int epoch[4096] = {};
+    int attempt = 0;
+    magicRandom rng(0x9E3779B97F4A7C15ULL);
+
+    for (short square = 0; square < 64; ++square) {
+        magicEntry &entry = magics[square];
+
+        // board edges never block a ray, unless the slider stands on that edge
+        uint64_t rowMask = RANK_8 << (8 * (square / 8));
+        uint64_t fileMask = FILE_A << (square % 8);
+        uint64_t edges = ((RANK_8 | RANK_1) & ~rowMask) | ((FILE_A | FILE_H) & ~fileMask);
+
+        entry.mask = slidingAttack(directions, square, 0) & ~edges;
+        entry.shift = 64 - __builtin_popcountll(entry.mask);
+
+        // enumerate every subset of the mask (Carry-Rippler) with its reference attacks
+        int size = 0;
+        uint64_t subset = 0;
+        do {
+            occupancy[size] = subset;
+            reference[size] = slidingAttack(directions, square, subset);
+            size++;
+            subset = (subset - entry.mask) & entry.mask;
+        } while (subset);
+
+        entry.attacks = (square == 0) ? table : magics[square - 1].attacks + (1 << (64 - magics[square - 1].shift));
+
+        // try random magics until every occupancy maps to a slot holding its own attack set
+        for (int i = 0; i < size; ) {
+            do {
+                entry.magic = rng.sparse();
+            } while (__builtin_popcountll((entry.magic * entry.mask) >> 56) < 6);
+
+            attempt++;
+            for (i = 0; i < size; ++i) {
+                unsigned idx = entry.magicIndex(occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    entry.attacks[idx] = reference[i];
+                } else if (entry.attacks[idx] != reference[i]) {
+                    break; // destructive collision, pick another magic
+                }
+            }
+        }
+    }
+}
+
+void AttackTables::initPext(const short directions[4][2], uint64_t table[], magicEntry magics[]) {
+    for (short square = 0; square < 64; ++square) {
+        magicEntry &entry = magics[square];
+
+        uint64_t rowMask = RANK_8 << (8 * (square / 8));
+        uint64_t fileMask = FILE_A << (square % 8);
+        uint64_t edges = ((RANK_8 | RANK_1) & ~rowMask) | ((FILE_A | FILE_H) & ~fileMask);
+
+        entry.mask = slidingAttack(directions, square, 0) & ~edges;
+        entry.shift = 64 - __builtin_popcountll(entry.mask);
+        entry.magic = 0;
+        entry.attacks = (square == 0) ? table : magics[square - 1].attacks + (1 << (64 - magics[square - 1].shift));
+
+        uint64_t subset = 0;
+        do {
+            entry.attacks[parallelBitsExtract(subset, entry.mask)] = slidingAttack(directions, square, subset);
+            subset = (subset - entry.mask) & entry.mask;
+        } while (subset);
+    }
+}
+
+const AttackTables::sliderTables &AttackTables::getActiveTables() {
+    static const sliderTables &active = *getTables(isPextSupported() ? PEXT_BACKEND : MAGIC_BACKEND);
+    return active;
+}
+
+short AttackTables::getBackend() {
+    return getActiveTables().pext ? PEXT_BACKEND : MAGIC_BACKEND;
+}
+
+const AttackTables::sliderTables *AttackTables::getTables(short backend) {
+    if (backend == PEXT_BACKEND) {
+        if (!isPextSupported()) {
+            return nullptr;
+        }
+        std::call_once(pextTablesBuilt, [] {
+            initPext(BISHOP_DIRECTIONS, pextTables.bishopTable, pextTables.bishopMagics);
+            initPext(ROOK_DIRECTIONS, pextTables.rookTable, pextTables.rookMagics);
+            pextTables.pext = true;
+        });
+        return &pextTables;
+    }
+    std::call_once(magicTablesBuilt, [] {
+        initMagics(BISHOP_DIRECTIONS, magicTables.bishopTable, magicTables.bishopMagics);
+        initMagics(ROOK_DIRECTIONS, magicTables.rookTable, magicTables.rookMagics);
+    });
+    return &magicTables;
+}
+
+bool AttackTables::isPextSupported() {
+#if PEXT_BACKEND_AVAILABLE
+    __builtin_cpu_init(); // needed when called from a static initializer
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
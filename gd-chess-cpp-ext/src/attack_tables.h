@@ -0,0 +1,238 @@
+#ifndef ATTACK_TABLES_H
+#define ATTACK_TABLES_H
+
+#include <cstdint>
+
+// The PEXT slider backend needs x86-64 and GCC style inline assembly, other targets only build the magic backend
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PEXT_BACKEND_AVAILABLE 1
+#else
+#define PEXT_BACKEND_AVAILABLE 0
+#endif
+
+// Lookups that only depend on the squares involved, generated by the compiler and stored as read-only data
+struct squareTables {
+    uint64_t knight[64];
+    uint64_t king[64];
+    uint64_t pawn[3][64];       // indexed by color, 1 = white captures towards square 0, 2 = black
+    uint64_t rays[8][64];       // squares from a square to the board edge, excluding the square itself
+    uint64_t between[64][64];   // squares strictly between two aligned squares
+    uint64_t line[64][64];      // full edge to edge line through two aligned squares
+};
+
+// Ray directions as {file step, row step}, each direction is followed by its opposite
+constexpr short RAY_DIRECTIONS[8][2] = {{0, -1}, {0, 1}, {1, 0}, {-1, 0}, {1, -1}, {-1, 1}, {1, 1}, {-1, -1}};
+
+constexpr bool onBoard(int x, int y) {
+    return x >= 0 && x < 8 && y >= 0 && y < 8;
+}
+
+constexpr uint64_t offsetsFrom(int square, const short offsets[8][2]) {
+    uint64_t targets = 0;
+    for (int i = 0; i < 8; ++i) {
+        int x = square % 8 + offsets[i][0];
+        int y = square / 8 + offsets[i][1];
+        if (onBoard(x, y)) {
+            targets |= 1ULL << (y * 8 + x);
+        }
+    }
+    return targets;
+}
+
+constexpr squareTables generateSquareTables() {
+    squareTables tables = {};
+    const short knightOffsets[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+
+    for (int square = 0; square < 64; ++square) {
+        tables.knight[square] = offsetsFrom(square, knightOffsets);
+        tables.king[square] = offsetsFrom(square, RAY_DIRECTIONS);
+
+        int x = square % 8;
+        int y = square / 8;
+        for (int dx = -1; dx <= 1; dx += 2) {
+            if (onBoard(x + dx, y - 1)) {
+                tables.pawn[1][square] |= 1ULL << ((y - 1) * 8 + x + dx);
+            }
+            if (onBoard(x + dx, y + 1)) {
+                tables.pawn[2][square] |= 1ULL << ((y + 1) * 8 + x + dx);
+            }
+        }
+
+        for (int direction = 0; direction < 8; ++direction) {
+            for (int tx = x + RAY_DIRECTIONS[direction][0], ty = y + RAY_DIRECTIONS[direction][1]; onBoard(tx, ty);
+                tx += RAY_DIRECTIONS[direction][0], ty += RAY_DIRECTIONS[direction][1]) {
+                tables.rays[direction][square] |= 1ULL << (ty * 8 + tx);
+            }
+        }
+    }
+
+    // walk every ray, the squares passed so far lie between the start and the current square
+    for (int square = 0; square < 64; ++square) {
+        for (int direction = 0; direction < 8; ++direction) {
+            uint64_t fullLine = tables.rays[direction][square] | tables.rays[direction ^ 1][square] | (1ULL << square);
+            uint64_t passed = 0;
+            int x = square % 8 + RAY_DIRECTIONS[direction][0];
+            int y = square / 8 + RAY_DIRECTIONS[direction][1];
+            for (; onBoard(x, y); x += RAY_DIRECTIONS[direction][0], y += RAY_DIRECTIONS[direction][1]) {
+                int target = y * 8 + x;
+                tables.between[square][target] = passed;
+                tables.line[square][target] = fullLine;
+                passed |= 1ULL << target;
+            }
+        }
+    }
+    return tables;
+}
+
+inline constexpr squareTables SQUARE_TABLES = generateSquareTables();
+
+// Precomputed attack lookups shared by every ChessLogic instance.
+// Squares use the same layout as ChessLogic::internalBoard (0 = a8, 63 = h1).
+class AttackTables {
+public:
+
+    static const uint64_t FILE_A = 0x0101010101010101ULL;
+    static const uint64_t FILE_B = 0x0202020202020202ULL;
+    static const uint64_t FILE_G = 0x4040404040404040ULL;
+    static const uint64_t FILE_H = 0x8080808080808080ULL;
+
+    // Fancy magic bitboard entry for a single square
+    struct magicEntry {
+        uint64_t mask;      // relevant occupancy (board edges excluded)
+        uint64_t magic;     // multiplier that hashes the masked occupancy
+        uint64_t *attacks;  // start of this square's slice of the attack table
+        unsigned shift;     // 64 - number of relevant occupancy bits
+
+        unsigned magicIndex(uint64_t occupied) const {
+            return unsigned(((occupied & mask) * magic) >> shift);
+        }
+    };
+
+    // Slider table backends, both give the same attacks
+    static const short MAGIC_BACKEND = 0;
+    static const short PEXT_BACKEND = 1;
+
+    // The entries and attack tables of one backend. Each backend has its own, so running a board on the other one
+    // never touches the tables the searches read
+    struct sliderTables {
+        magicEntry bishopMagics[64];
+        magicEntry rookMagics[64];
+        uint64_t bishopTable[0x1480]; // 5248 entries for all bishop squares
+        uint64_t rookTable[0x19000];  // 102400 entries for all rook squares
+        bool pext;
+
+        // Slider attacks from a square given the board occupancy. Reached through the board's tables pointer, the
+        // lookup tests the backend flag, then computes the index with a multiply and a shift (a single pext with the
+        // PEXT backend) and loads the attack set
+        uint64_t bishopAttacks(short square, uint64_t occupied) const {
+            const magicEntry &entry = bishopMagics[square];
+            return entry.attacks[index(entry, occupied)];
+        }
+
+        uint64_t rookAttacks(short square, uint64_t occupied) const {
+            const magicEntry &entry = rookMagics[square];
+            return entry.attacks[index(entry, occupied)];
+        }
+
+        uint64_t queenAttacks(short square, uint64_t occupied) const {
+            return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+        }
+
+    private:
+        // The flag is the same for every lookup of a table set, so the branch is always predicted. Compiling the
+        // move generation once per backend would remove it, at the cost of a second copy of every search template
+        unsigned index(const magicEntry &entry, uint64_t occupied) const {
+#if PEXT_BACKEND_AVAILABLE
+            if (pext) {
+                return unsigned(parallelBitsExtract(occupied, entry.mask));
+            }
+#endif
+            return entry.magicIndex(occupied);
+        }
+    };
+
+    // Leaper attacks from a single square, a single load from the compile time tables
+    static uint64_t knightAttacks(short square) {
+        return SQUARE_TABLES.knight[square];
+    }
+
+    static uint64_t kingAttacks(short square) {
+        return SQUARE_TABLES.king[square];
+    }
+
+    static uint64_t pawnAttacks(short square, short color) {
+        return SQUARE_TABLES.pawn[color][square];
+    }
+
+    // Squares attacked by a set of pawns, white pawns capture towards square 0
+    static uint64_t allPawnAttacks(uint64_t pawns, short color) {
+        if (color == 1) {
+            return ((pawns >> 9) & ~FILE_H) | ((pawns >> 7) & ~FILE_A);
+        }
+        return ((pawns << 7) & ~FILE_H) | ((pawns << 9) & ~FILE_A);
+    }
+
+    // Squares strictly between two aligned squares, empty when they share no line
+    static uint64_t between(short fromSquare, short toSquare) {
+        return SQUARE_TABLES.between[fromSquare][toSquare];
+    }
+
+    // The full edge to edge line through two aligned squares, empty when they share no line
+    static uint64_t line(short fromSquare, short toSquare) {
+        return SQUARE_TABLES.line[fromSquare][toSquare];
+    }
+
+    // Squares from square to the board edge in one of the RAY_DIRECTIONS
+    static uint64_t ray(short direction, short square) {
+        return SQUARE_TABLES.rays[direction][square];
+    }
+
+    // The tables of the backend picked when the library is loaded, PEXT when the CPU supports BMI2.
+    // The choice never changes afterwards
+    static const sliderTables &getActiveTables();
+
+    static short getBackend();
+
+    // The tables of a backend, built the first time they are asked for. nullptr if the CPU cannot run it
+    static const sliderTables *getTables(short backend);
+
+    // CPUID check for BMI2, which provides the pext instruction
+    static bool isPextSupported();
+
+private:
+    static uint64_t slidingAttack(const short directions[4][2], short square, uint64_t occupied);
+
+    static void initMagics(const short directions[4][2], uint64_t table[], magicEntry magics[]);
+
+    // Same table layout as the magics, but every occupancy subset is stored at its pext index
+    static void initPext(const short directions[4][2], uint64_t table[], magicEntry magics[]);
+
+    static uint64_t parallelBitsExtract(uint64_t source, uint64_t mask) {
+#if PEXT_BACKEND_AVAILABLE
+        uint64_t result;
+        asm("pextq %2, %1, %0" : "=r"(result) : "r"(source), "r"(mask)); // no -mbmi2 needed, only run after the CPUID check
+        return result;
+#else
+        (void)source;
+        (void)mask;
+        return 0;
+#endif
+    }
+};
+
+// Bit helpers used when iterating over bitboards
+inline short bitScanForward(uint64_t bitboard) {
+    return static_cast<short>(__builtin_ctzll(bitboard));
+}
+
+inline short popLeastSignificantBit(uint64_t &bitboard) {
+    short square = bitScanForward(bitboard);
+    bitboard &= bitboard - 1;
+    return square;
+}
+
+inline int popCount(uint64_t bitboard) {
+    return __builtin_popcountll(bitboard);
+}
+
+#endif // ATTACK_TABLES_H
@@ -8,7 +8,7 @@ ChessLogic::evalMove BestEvalMoveStrategy::getBestMove(ChessLogic &logic, Evalua
     std::random_device rd;
     std::mt19937 rGen(rd());   // Mersenne Twister engine
 
-    std::vector<ChessLogic::Move> legalMoves = logic.getLegalMoves(isWhite);
+    ChessLogic::MoveList legalMoves = orderRootMoves(logic, isWhite);
     
     if (legalMoves.empty()) {
         return ChessLogic::evalMove(0, ChessLogic::Move()); // Return a null move if no legal moves are available
@@ -22,12 +22,15 @@ ChessLogic::evalMove BestEvalMoveStrategy::getBestMove(ChessLogic &logic, Evalua
     const int high = std::numeric_limits<int>::max();
     int bestScore = isWhite ? low : high;
     const int jiggle = 30; // randomize choice between equivalent moves
+    killerTable killers;
+    historyTable history;
+    uint64_t nodes = 0;
 
     for (const auto &move : legalMoves) {
         logic.makeMove(move);
         
         // Perform recursive search
-        int score = betaAlphaMinimax(&logic, high, low, evalStrategy, !isWhite, searchDepth - 1, stopTime); // score will be positive for white, negative for black
+        int score = betaAlphaMinimax(&logic, high, low, evalStrategy, !isWhite, searchDepth - 1, stopTime, killers, history, 1, nodes); // score will be positive for white, negative for black
 
         logic.undoMove();
 
@@ -59,6 +62,7 @@ ChessLogic::evalMove BestEvalMoveStrategy::getBestMove(ChessLogic &logic, Evalua
             break; // Exit early if the time limit is exceeded
         }
     }
+    nodeCount += nodes;
 
     if (bestMoves.size() > 1) {
         std::uniform_int_distribution<> dis(0, bestMoves.size() - 1); // Uniform distribution in the range [0, size-1]
@@ -80,7 +84,7 @@ ChessLogic::evalMove BestEvalMoveStrategy::getBestMove(ChessLogic &logic, Evalua
     bestMoves.push_back(ChessLogic::Move());
     int bestScore = 0;
 
-    std::vector<ChessLogic::Move> legalMoves = logic.getLegalMoves(isWhite);
+    ChessLogic::MoveList legalMoves = orderRootMoves(logic, isWhite);
 
     if (legalMoves.empty()) {
         return ChessLogic::evalMove(0, ChessLogic::Move()); // Return a null move if no legal moves are available
@@ -120,11 +124,10 @@ void BestEvalMoveStrategy::getBestMoveThreaded(ChessLogic &logicBoard, Evaluatio
     std::random_device rd;
     std::mt19937 rGen(rd());   // Mersenne Twister engine
     
-    ChessLogic logic = ChessLogic(logicBoard.internalBoard, logicBoard.moveStack, logicBoard.castleStack, logicBoard.whiteKCastle,
-        logicBoard.whiteQCastle, logicBoard.blackKCastle, logicBoard.blackQCastle, logicBoard.enPassantSquare); // create own copy of the board
+    ChessLogic logic(logicBoard.getPosition()); // create own copy of the board
     
     ChessLogic::evalMove thinkingMove = ChessLogic::evalMove(0, ChessLogic::Move());
-    std::vector<ChessLogic::Move> legalMoves = logic.getLegalMoves(isWhite);
+    ChessLogic::MoveList legalMoves = orderRootMoves(logic, isWhite);
 
     if (legalMoves.empty()) {
         // update the bestMove
@@ -152,13 +155,15 @@ void BestEvalMoveStrategy::getBestMoveThreaded(ChessLogic &logicBoard, Evaluatio
         const int high = std::numeric_limits<int>::max();
         int bestScore = isWhite ? low : high;
         const int jiggle = 30; // randomize choice between equivalent moves
-
+        killerTable killers;
+        historyTable history;
+        uint64_t nodes = 0;
 
         for (const auto &move : legalMoves) {
             logic.makeMove(move);
             
             // Perform recursive search
-            int score = betaAlphaMinimax(&logic, high, low, evalStrategy, !isWhite, searchDepth - 1, stopTime); // score will be positive for white, negative for black
+            int score = betaAlphaMinimax(&logic, high, low, evalStrategy, !isWhite, searchDepth - 1, stopTime, killers, history, 1, nodes); // score will be positive for white, negative for black
     
             logic.undoMove();
     
@@ -190,6 +195,7 @@ void BestEvalMoveStrategy::getBestMoveThreaded(ChessLogic &logicBoard, Evaluatio
                 break; // Exit early if the time limit is exceeded
             }
         } // end of for loop
+        nodeCount += nodes;
 
         if (bestMoves.size() > 1) {
             std::uniform_int_distribution<> dis(0, bestMoves.size() - 1); // Uniform distribution in the range [0, size-1]
@@ -221,36 +227,93 @@ void BestEvalMoveStrategy::getBestMoveThreaded(ChessLogic &logicBoard, Evaluatio
 }
 
 int BestEvalMoveStrategy::betaAlphaMinimax(ChessLogic * logic, int beta, int alpha, EvaluationStrategy* evalStrategy, bool isWhite, 
-    short depth, std::chrono::time_point<std::chrono::steady_clock> stopTime) {
-        int bestScore = isWhite ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    short depth, std::chrono::time_point<std::chrono::steady_clock> stopTime, killerTable &killers, historyTable &history,
+    short ply, uint64_t &nodes) {
+        if (isWhite) {
+            return betaAlphaMinimax<ChessLogic::WHITE>(logic, beta, alpha, evalStrategy, depth, stopTime, killers, history, ply, nodes);
+        }
+        return betaAlphaMinimax<ChessLogic::BLACK>(logic, beta, alpha, evalStrategy, depth, stopTime, killers, history, ply, nodes);
+    }
 
+template<short color>
+int BestEvalMoveStrategy::betaAlphaMinimax(ChessLogic * logic, int beta, int alpha, EvaluationStrategy* evalStrategy,
+    short depth, std::chrono::time_point<std::chrono::steady_clock> stopTime, killerTable &killers, historyTable &history,
+    short ply, uint64_t &nodes) {
+        constexpr bool isWhite = (color == ChessLogic::WHITE);
+        constexpr short opponentColor = isWhite ? ChessLogic::BLACK : ChessLogic::WHITE;
+        int bestScore = isWhite ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+        ++nodes;
+
+        // an earlier search of the position gives the move to try first, and may already bound the score
+        uint64_t positionKey = logic->getPositionKey();
+        ChessLogic::Move hashMove = ChessLogic::Move();
+        TranspositionTable::ttResult stored;
+        if (transpositionTable && depth > 0 && transpositionTable->probe(positionKey, stored)) {
+            hashMove = stored.move;
+            bool mateScore = std::abs(stored.score) >= MATE_SCORE;
+            if (stored.depth == depth || (stored.depth > depth && !mateScore)) {
+                if (stored.bound == TranspositionTable::EXACT_BOUND) {
+                    return stored.score;
+                } else if (stored.bound == TranspositionTable::LOWER_BOUND) {
+                    alpha = std::max(alpha, stored.score);
+                } else {
+                    beta = std::min(beta, stored.score);
+                }
+                if (beta <= alpha) {
+                    return stored.score;
+                }
+            }
+        }
+        const int searchedAlpha = alpha;
+        const int searchedBeta = beta;
+        ChessLogic::Move bestMove = ChessLogic::Move();
 
-        std::vector<ChessLogic::Move> legalMoves = logic->getLegalMoves(isWhite);
+        // moves come one stage at a time, a cutoff on a capture or killer never generates the quiet moves
+        MovePicker<color> picker(*logic, hashMove, moveOrdering ? killers.at(ply) : nullptr, moveOrdering ? &history : nullptr);
+        ChessLogic::Move move = picker.next();
        
-        if (legalMoves.size() == 0) {
-            if (logic->isInCheck(isWhite)) {
+        if (move.isNull()) {
+            if (logic->isInCheck<color>()) {
                 return isWhite ? -30000 + (depth * -1000) : 30000 + (depth * 1000);
             }
             return 0; // stalemate
         }
 
         if (depth == 0) {
-            return evalStrategy->evaluate(logic, isWhite);
+            if (quiescenceMode == QuiescenceSearch::OFF) {
+                return evalStrategy->evaluate(logic, isWhite);
+            }
+            // the quiescence search is negamax, black searches the negated white-relative window
+            QuiescenceSearch quiescence(evalStrategy, quiescenceMode, nodes);
+            int lower = std::max(alpha, -QuiescenceSearch::INFINITE_SCORE);
+            int upper = std::min(beta, QuiescenceSearch::INFINITE_SCORE);
+            if (isWhite) {
+                return quiescence.search<color>(*logic, lower, upper, ply);
+            }
+            return -quiescence.search<color>(*logic, -upper, -lower, ply);
         }
 
-        for (const ChessLogic::Move move : legalMoves) {
+        for (; !move.isNull(); move = picker.next()) {
 
             logic->makeMove(move);
             
-            int score = betaAlphaMinimax(logic, beta, alpha, evalStrategy, !isWhite, depth - 1, stopTime);
+            int score = betaAlphaMinimax<opponentColor>(logic, beta, alpha, evalStrategy, depth - 1, stopTime, killers, history, ply + 1, nodes);
 
             logic->undoMove();
 
+            if (bestMove.isNull() || (isWhite ? score > bestScore : score < bestScore)) {
+                bestMove = move;
+            }
+
             if (isWhite) {  // pick negative score for black & positive for white
 
                 bestScore = std::max(bestScore, score);
                 alpha = std::max(alpha, score);
                 if (beta <= alpha) {
+                    if (move.capture() == 0 && move.promotion() == 0) {
+                        killers.update(ply, move);
+                        history.update(move, depth);
+                    }
                     break;
                 }
 
@@ -258,24 +321,61 @@ int BestEvalMoveStrategy::betaAlphaMinimax(ChessLogic * logic, int beta, int alp
                 bestScore = std::min(bestScore, score);
                 beta = std::min(beta, score);
                 if (alpha >= beta) {
+                    if (move.capture() == 0 && move.promotion() == 0) {
+                        killers.update(ply, move);
+                        history.update(move, depth);
+                    }
                     break;
                 }
             }
 
 
             if (std::chrono::steady_clock::now() >= stopTime) {
-                return 0; // Exit early if the time limit is exceeded
+                return 0; // Exit early if the time limit is exceeded, nothing unfinished goes into the table
+            }
+        }
+
+        // a child cut short by the clock returns 0, so only results finished in time go into the table
+        if (transpositionTable && std::chrono::steady_clock::now() < stopTime) {
+            short bound = TranspositionTable::EXACT_BOUND;
+            if (bestScore <= searchedAlpha) {
+                bound = TranspositionTable::UPPER_BOUND;
+            } else if (bestScore >= searchedBeta) {
+                bound = TranspositionTable::LOWER_BOUND;
             }
+            transpositionTable->store(positionKey, bestMove, bestScore, depth, bound);
         }
         
         return bestScore;
     }
 
+ChessLogic::MoveList BestEvalMoveStrategy::orderRootMoves(const ChessLogic &logic, bool isWhite) const {
+    if (isWhite) {
+        return orderRootMoves<ChessLogic::WHITE>(logic);
+    }
+    return orderRootMoves<ChessLogic::BLACK>(logic);
+}
+
+template<short color>
+ChessLogic::MoveList BestEvalMoveStrategy::orderRootMoves(const ChessLogic &logic) const {
+    ChessLogic::Move hashMove = ChessLogic::Move();
+    TranspositionTable::ttResult stored;
+    if (transpositionTable && transpositionTable->probe(logic.getPositionKey(), stored)) {
+        hashMove = stored.move;
+    }
+
+    ChessLogic::MoveList moves;
+    MovePicker<color> picker(logic, hashMove);
+    for (ChessLogic::Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        moves.push_back(move);
+    }
+    return moves;
+}
+
 static void threadedTest(BestEvalMoveStrategy * moveStrategy, ChessLogic &logic, const std::vector<ChessLogic::Move> searchMoves) {
     std::cout << "in threaded test" << std::endl;
 
-    ChessLogic myCopy = ChessLogic(logic.internalBoard, logic.moveStack, logic.castleStack, logic.whiteKCastle,
-        logic.whiteQCastle, logic.blackKCastle, logic.blackQCastle, logic.enPassantSquare);
+    ChessLogic myCopy = logic;
         DEBUG_PRINT("copied board");
     for(int i = 0; i < 10000; i++) {
         if (i % 100 == 0) {
@@ -293,19 +393,21 @@ void BestEvalMoveStrategy::threadedSearch(ChessLogic &logicBoard, const std::vec
     std::vector<ChessLogic::Move> &bestMoves, int &bestScore, std::mutex &mtx,  EvaluationStrategy * evalStrategy, 
     bool isWhite, short searchDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) {
 
-        ChessLogic logic = ChessLogic(logicBoard.internalBoard, logicBoard.moveStack, logicBoard.castleStack, logicBoard.whiteKCastle,
-            logicBoard.whiteQCastle, logicBoard.blackKCastle, logicBoard.blackQCastle, logicBoard.enPassantSquare);
+        ChessLogic logic(logicBoard.getPosition());
 
         const int low = std::numeric_limits<int>::min();
         const int high = std::numeric_limits<int>::max();
         const int jiggle = 30; // randomize choice between equivalent moves
+        killerTable killers;
+        historyTable history;
+        uint64_t nodes = 0;
 
         for (auto move : searchMoves) {
 
             logic.makeMove(move);
         
             // // Perform recursive search
-            int score = betaAlphaMinimax(&logic, high, low, evalStrategy, !isWhite, searchDepth - 1, stopTime); // score will be positive for white, negative for black
+            int score = betaAlphaMinimax(&logic, high, low, evalStrategy, !isWhite, searchDepth - 1, stopTime, killers, history, 1, nodes); // score will be positive for white, negative for black
     
             logic.undoMove();
 
@@ -337,6 +439,7 @@ void BestEvalMoveStrategy::threadedSearch(ChessLogic &logicBoard, const std::vec
                 break; // Exit early if the time limit is exceeded
             }
         }
+        nodeCount += nodes;
 
 
     }
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include <mutex>
 #include "chess_logic.h"
 #include "move_strategy.h"
+#include "move_picker.h"
+#include "transposition_table.h"
 
 #ifdef DEBUG
 #define DEBUG_PRINT(x) std::cout << "Debug: " << x << "\n";
@@ -22,6 +24,9 @@ class BestEvalMoveStrategy : public MoveStrategy {
 public:
     BestEvalMoveStrategy() = default;
 
+    // see TranspositionTable for who owns the table
+    explicit BestEvalMoveStrategy(TranspositionTable *transpositionTable) : transpositionTable(transpositionTable) {}
+
     ChessLogic::evalMove getBestMove(ChessLogic &logic, EvaluationStrategy* evalStrategy,
         bool isWhite, short searchDepth, 
         std::chrono::time_point<std::chrono::steady_clock> stopTime) override;
@@ -36,8 +41,27 @@ public:
     
 protected:
 
+TranspositionTable *transpositionTable = nullptr;
+
+// Scores at or beyond this are mate scores, they depend on the remaining depth so they are only reused at the same depth.
+// Mates found by the quiescence search score a little under 30000
+static const int MATE_SCORE = 29000;
+
 int betaAlphaMinimax(ChessLogic * logic, int beta, int alpha, EvaluationStrategy* evalStrategy, bool isWhite, 
-    short depth, std::chrono::time_point<std::chrono::steady_clock> stopTime);
+    short depth, std::chrono::time_point<std::chrono::steady_clock> stopTime, killerTable &killers, historyTable &history,
+    short ply, uint64_t &nodes);
+
+// The recursion with the side to move fixed at compile time, the bool overload above picks the instantiation
+template<short color>
+int betaAlphaMinimax(ChessLogic * logic, int beta, int alpha, EvaluationStrategy* evalStrategy,
+    short depth, std::chrono::time_point<std::chrono::steady_clock> stopTime, killerTable &killers, historyTable &history,
+    short ply, uint64_t &nodes);
+
+// Legal moves in MovePicker order, the hash move first when the table has one for the root
+ChessLogic::MoveList orderRootMoves(const ChessLogic &logic, bool isWhite) const;
+
+template<short color>
+ChessLogic::MoveList orderRootMoves(const ChessLogic &logic) const;
 
 void threadedSearch(ChessLogic &logic, const std::vector<ChessLogic::Move> searchMoves, 
     std::vector<ChessLogic::Move> &bestMoves, int &bestScore, std::mutex &mtx,  EvaluationStrategy* evalStrategy, 
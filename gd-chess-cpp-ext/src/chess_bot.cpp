@@ -2,7 +2,7 @@
 
 ChessBot::ChessBot() {
     botLogic = ChessLogic();
-    moveStrategy = new BestEvalMoveStrategy();
+    moveStrategy = new BestEvalMoveStrategy(&transpositionTable);
     // moveStrategy = new RandomMoveStrategy();
     currentMoveStrategy = BEST_EVAL_MOVE_STRATEGY;
     // currentMoveStrategy = RANDOM_STRATEGY;
@@ -50,7 +50,7 @@ bool ChessBot::validateMove(const std::string &move) {
         return false; // No movement
     }
 
-    if (halfMoveClock >= 100) {
+    if (botLogic.halfMoveClock >= 100) {
         return false; // 50-move rule
     }
 
@@ -64,19 +64,12 @@ void ChessBot::applyMove(const std::string &move) {
     // Apply the move using the bot logic
     ChessLogic::Move translatedMove = botLogic.translateMove(move);
     botLogic.makeMove(translatedMove);
+    gameMoves.push_back(translatedMove);
 
     // Update the turn
     isWhiteTurn = !isWhiteTurn;
 
-    // Update the half move clock
-    halfMoveClock++;
-    if (translatedMove.piece == 1) { // If a pawn is moved
-
-        halfMoveClock = 0; // Reset the half move clock
-    }
-    if (botLogic.getChessBoard()[translatedMove.to].color != 0) { // If a piece is captured
-        halfMoveClock = 0; // Reset the half move clock
-    }
+    // The half move clock is kept by makeMove
 
     // Update the full move number
     if (isWhiteTurn) {
@@ -135,12 +128,14 @@ void ChessBot::setFEN(const std::string &fen) {
         } else {
             botLogic.enPassantSquare = -1;
         }
-        halfMoveClock = halfMove;
+        botLogic.halfMoveClock = halfMove;
         fullMoveNumber = fullMove;
 
         // Update the bot logic with the new board state
         botLogic.copyChessBoard(chessBoard);
         botLogic.emtpyMoveStack();
+        gameMoves.clear();
+        botLogic.setSideToMove(isWhiteTurn);
 
     } else {
         fprintf(stderr, "Invalid FEN string format. Aborting program.\n");
@@ -191,7 +186,7 @@ const std::string ChessBot::getFEN() {
     fen += " ";
     fen += (botLogic.enPassantSquare != -1) ? botLogic.squareToString(botLogic.enPassantSquare) : "-";
     fen += " ";
-    fen += std::to_string(halfMoveClock) + " " + std::to_string(fullMoveNumber);
+    fen += std::to_string(botLogic.halfMoveClock) + " " + std::to_string(fullMoveNumber);
 
     return fen;
 }
@@ -201,6 +196,8 @@ ChessLogic::Move ChessBot::iterativeDeepeningSearch(short searchDepth, std::chro
     ChessLogic::Move bestMove = ChessLogic::Move();
     int bestScore = -1;
     short lastDepth = 0;
+    transpositionTable.newSearch();
+    moveStrategy->resetNodeCount();
     for (short depth = 1; depth <= searchDepth; ++depth) {
         const ChessLogic::evalMove aMove = moveStrategy->getBestMove(botLogic, evalStrategy, isWhiteTurn, depth, stopTime);
         if (std::chrono::steady_clock::now() >= stopTime) {
@@ -234,12 +231,20 @@ ChessLogic::Move ChessBot::iterativeDeepeningSearch(short searchDepth, short thr
         depthStack.push(i);
     }
     std::vector<std::thread> threads;
+    transpositionTable.newSearch();
+    moveStrategy->resetNodeCount();
 
     // start threads
     for (int i = 0; i < threadCount; i++) {
-        threads.push_back(
-            std::thread(&MoveStrategy::getBestMoveThreaded, moveStrategy, std::ref(botLogic), evalStrategy, isWhiteTurn, std::ref(depthStack),
-            std::ref(bestMoveSet), std::ref(mtx), std::ref(lastDepth), stopTime));
+        if (lazySmp) {
+            threads.push_back(
+                std::thread(&MoveStrategy::getBestMoveLazySmp, moveStrategy, std::ref(botLogic), evalStrategy, isWhiteTurn, searchDepth,
+                short(i), std::ref(bestMoveSet), std::ref(mtx), std::ref(lastDepth), stopTime));
+        } else {
+            threads.push_back(
+                std::thread(&MoveStrategy::getBestMoveThreaded, moveStrategy, std::ref(botLogic), evalStrategy, isWhiteTurn, std::ref(depthStack),
+                std::ref(bestMoveSet), std::ref(mtx), std::ref(lastDepth), stopTime));
+        }
     }
 
     // join threads
@@ -253,41 +258,66 @@ ChessLogic::Move ChessBot::iterativeDeepeningSearch(short searchDepth, short thr
     return bestMoveSet.back().move;
 }
 
+void ChessBot::setHashSize(int hashSizeMB) {
+    if (hashSizeMB < 1) {
+        std::cerr << "Error: Invalid hash size: " << hashSizeMB << " MB" << std::endl;
+        abort();
+    }
+    transpositionTable.resize(hashSizeMB);
+}
+
 bool ChessBot::isCheck() const {
     return botLogic.isInCheck(isWhiteTurn);
 }
 
 std::vector<ChessLogic::Move> ChessBot::getMoveHistory() const {
-    return botLogic.getMoveHistory();
+    return gameMoves;
 }
 
 std::vector<std::string> ChessBot::translateMoveHistory() const {
     std::vector<std::string> translatedMoves;
-    for (const auto &move : botLogic.getMoveHistory()) {
+    for (const auto &move : gameMoves) {
         translatedMoves.push_back(botLogic.translateMoveToString(move));
     }
     return translatedMoves;
 }
 
 bool ChessBot::isThreefoldRepetition() const {
-    std::unordered_map<uint64_t, int> positionCount;
-    for (const auto &move : botLogic.getMoveHistory()) {
-        uint64_t hash = botLogic.hashPosition(isWhiteTurn);
-        positionCount[hash]++;
-        if (positionCount[hash] >= 3) {
-            return true; // Threefold repetition detected
+    return botLogic.getRepetitionCount() >= 2; // the current position is the third occurrence
+}
+
+bool ChessBot::isStaleMate() {
+    return (!botLogic.isInCheck(isWhiteTurn) && !hasLegalMove()) || 
+        isThreefoldRepetition() || botLogic.halfMoveClock >= 100;
+}
+
+short ChessBot::getGameResult() {
+    bool inCheck = botLogic.isInCheck(isWhiteTurn);
+    if (!hasLegalMove()) {
+        if (inCheck) {
+            return isWhiteTurn ? 3 : 2; // the side to move is mated
         }
+        return 4; // Stalemate
+    }
+    if (isThreefoldRepetition() || botLogic.halfMoveClock >= 100) {
+        return 4; // Draw
     }
-    return false;
+    return inCheck ? 1 : 0;
 }
 
-bool ChessBot::isStaleMate() {
-    return (!botLogic.isInCheck(isWhiteTurn) && botLogic.getLegalMoves(isWhiteTurn).empty()) || 
-        isThreefoldRepetition() || halfMoveClock >= 100;
+bool ChessBot::hasLegalMove() {
+    // the key covers the board, castling, en passant and side to move, everything the legal moves depend on
+    uint64_t key = botLogic.getPositionKey();
+    if (!legalMoveCacheValid || legalMoveCacheKey != key) {
+        cachedHasLegalMove = botLogic.hasAnyLegalMove(isWhiteTurn ? 1 : 2);
+        legalMoveCacheKey = key;
+        legalMoveCacheValid = true;
+    }
+    return cachedHasLegalMove;
 }
 
 std::string ChessBot::getAvailableMoves() {
-    std::vector<ChessLogic::Move> legalMoves = botLogic.getLegalMoves(isWhiteTurn);
+    ChessLogic::MoveList legalMoves = botLogic.getLegalMoves(isWhiteTurn);
 
     std::string moves; // static needed to keep the string alive after function returns
     for (const auto &move : legalMoves) {
@@ -305,4 +335,144 @@ std::string ChessBot::getAvailableMoves() {
 
 const std::string ChessBot::whosTurn() const {
     return isWhiteTurn ? "white" : "black";
-}
\ No newline at end of file
+}
+
+std::string ChessBot::perft(short depth) {
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t nodes = botLogic.perft(depth);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+    return perftReport(nodes, elapsed.count());
+}
+
+// Takes move pairs from the shared list until it is empty, counting the subtree below each pair on its own copy of the board
+static void perftWorker(ChessPosition position, const std::vector<std::pair<ChessLogic::Move, ChessLogic::Move>> &tasks,
+    std::atomic<size_t> &nextTask, std::atomic<uint64_t> &nodes, short depth, PerftHash *hash) {
+
+    ChessLogic logic(position);
+    for (size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+        logic.makeMove(tasks[i].first);
+        logic.makeMove(tasks[i].second);
+        nodes += hash ? logic.perft(depth, *hash) : logic.perft(depth);
+        logic.undoMove();
+        logic.undoMove();
+    }
+}
+
+std::string ChessBot::perft(short depth, short threadCount, int hashSizeMB) {
+    if (depth < 3 || threadCount < 2) {
+        return perft(depth); // not enough work to share
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // split the tree two plies deep, the root alone has too few moves to keep every thread busy
+    std::vector<std::pair<ChessLogic::Move, ChessLogic::Move>> tasks;
+    ChessLogic::MoveList rootMoves;
+    botLogic.generateLegalMoves(isWhiteTurn ? 1 : 2, rootMoves);
+    for (const auto &rootMove : rootMoves) {
+        botLogic.makeMove(rootMove);
+        ChessLogic::MoveList replies;
+        botLogic.generateLegalMoves(isWhiteTurn ? 2 : 1, replies);
+        for (const auto &reply : replies) {
+            tasks.push_back(std::make_pair(rootMove, reply));
+        }
+        botLogic.undoMove();
+    }
+
+    std::unique_ptr<PerftHash> hash;
+    if (hashSizeMB > 0) {
+        hash.reset(new PerftHash(hashSizeMB));
+    }
+
+    std::atomic<size_t> nextTask(0);
+    std::atomic<uint64_t> nodes(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.push_back(std::thread(perftWorker, botLogic.getPosition(), std::cref(tasks), std::ref(nextTask), std::ref(nodes),
+            short(depth - 2), hash.get()));
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+    return perftReport(nodes, elapsed.count());
+}
+
+std::string ChessBot::divide(short depth) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::pair<ChessLogic::Move, uint64_t>> counts = botLogic.divide(depth);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+    std::string report;
+    uint64_t nodes = 0;
+    for (const auto &count : counts) {
+        report += botLogic.translateMoveToString(count.first) + ": " + std::to_string(count.second) + "\n";
+        nodes += count.second;
+    }
+    return report + "\n" + perftReport(nodes, elapsed.count());
+}
+
+int ChessBot::see(const std::string &move) const {
+    return botLogic.see(botLogic.translateMove(move));
+}
+
+bool ChessBot::givesCheck(const std::string &move) const {
+    return botLogic.givesCheck(botLogic.translateMove(move));
+}
+
+void ChessBot::applyNullMove() {
+    botLogic.makeNullMove();
+    isWhiteTurn = !isWhiteTurn;
+    if (isWhiteTurn) {
+        fullMoveNumber++;
+    }
+}
+
+void ChessBot::undoNullMove() {
+    if (!botLogic.undoNullMove()) {
+        return;
+    }
+    if (isWhiteTurn) {
+        fullMoveNumber--;
+    }
+    isWhiteTurn = !isWhiteTurn;
+}
+
+uint64_t ChessBot::getPositionKey() const {
+    return botLogic.getPositionKey();
+}
+
+int ChessBot::getRepetitionCount() const {
+    return botLogic.getRepetitionCount();
+}
+
+std::string ChessBot::benchSliderBackends(short depth) {
+    const short backends[2] = {AttackTables::MAGIC_BACKEND, AttackTables::PEXT_BACKEND};
+    const char *names[2] = {"magic", "pext"};
+
+    std::string report;
+    for (int i = 0; i < 2; i++) {
+        report += std::string("Slider backend: ") + names[i] + "\n";
+        // a board of its own reads the backend's tables, the active backend of every other board is left alone
+        ChessLogic logic(botLogic.getPosition());
+        if (!logic.setSliderBackend(backends[i])) {
+            report += "Not supported by this CPU\n\n";
+            continue;
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        uint64_t nodes = logic.perft(depth);
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+        report += perftReport(nodes, elapsed.count()) + "\n";
+    }
+
+    return report;
+}
+
+std::string ChessBot::perftReport(uint64_t nodes, long long microseconds) const {
+    uint64_t nodesPerSecond = uint64_t(nodes * 1000000.0 / std::max(microseconds, 1LL));
+    return "Nodes searched: " + std::to_string(nodes) + "\n" +
+        "Time (ms): " + std::to_string(microseconds / 1000) + "\n" +
+        "Nodes/second: " + std::to_string(nodesPerSecond) + "\n";
+}
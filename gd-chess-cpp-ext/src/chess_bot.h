@@ -8,12 +8,17 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <thread>
+#include <atomic>
+#include <memory>
 #include "chess_logic.h"
+#include "attack_tables.h"
 #include "move_strategy.h"
 #include "eval_strategy.h"
 #include "random_move.h"
 #include "no_eval.h"
 #include "best_eval_move.h"
+#include "pvs_move.h"
 #include "material_eval.h"
 #include "position_eval.h"
 #include "mat_pos_eval.h"
@@ -31,6 +36,7 @@ protected:
     // move strategies
     const std::string BEST_EVAL_MOVE_STRATEGY = "best_eval_move";
     const std::string RANDOM_STRATEGY = "random";
+    const std::string PVS_STRATEGY = "pvs";
 
     // evaluation strategies
     const std::string POSITION_EVAL_STRATEGY = "position_eval";
@@ -38,6 +44,19 @@ protected:
     const std::string MAT_POS_EVAL_STRATEGY = "mat_pos_eval";
     const std::string NO_EVAL_STRATEGY = "no_eval";
 
+    // quiescence modes
+    const std::string QUIESCENCE_OFF = "off";
+    const std::string QUIESCENCE_CAPTURES = "captures";
+    const std::string QUIESCENCE_CHECK_EVASIONS = "check_evasions";
+
+    // how the threaded search shares the work
+    const std::string SMP_DEPTH_SPLIT = "depth_split"; // each thread takes the next depth, a tree of its own
+    const std::string SMP_LAZY = "lazy";               // every thread searches the root, sharing the hash table
+
+    // move ordering beyond the hash move and MVV-LVA
+    const std::string MOVE_ORDERING_ON = "on";   // killers and history
+    const std::string MOVE_ORDERING_OFF = "off";
+
     MoveStrategy *moveStrategy = nullptr;
     EvaluationStrategy *evalStrategy = nullptr;
 
@@ -77,6 +96,15 @@ public:
 
     bool validateMove(const std::string &move);
 
+    // Positions the last getBestMove call searched, over every iteration and thread
+    uint64_t getNodeCount() const
+    {
+        return moveStrategy->getNodeCount();
+    }
+
+    // Resizes the search transposition table, the results stored so far are lost
+    void setHashSize(int hashSizeMB);
+
     void setMoveStrategy(const std::string &strategy)
     {
         if (moveStrategy != nullptr)
@@ -84,6 +112,7 @@ public:
             delete moveStrategy;
             currentMoveStrategy = "";
         }
+        transpositionTable.clear(); // best_eval_move stores white-relative scores, pvs side to move ones
 
         if (strategy == RANDOM_STRATEGY)
         {
@@ -92,14 +121,78 @@ public:
         }
         else if (strategy == BEST_EVAL_MOVE_STRATEGY)
         {
-            moveStrategy = new BestEvalMoveStrategy();
+            moveStrategy = new BestEvalMoveStrategy(&transpositionTable);
             currentMoveStrategy = BEST_EVAL_MOVE_STRATEGY;
         }
+        else if (strategy == PVS_STRATEGY)
+        {
+            moveStrategy = new PvsMoveStrategy(&transpositionTable);
+            currentMoveStrategy = PVS_STRATEGY;
+        }
         else
         {
             std::cerr << "Error: Invalid move strategy: " << strategy << std::endl;
             abort(); // Invalid strategy
         }
+        moveStrategy->setQuiescenceMode(quiescenceMode);
+        moveStrategy->setMoveOrdering(moveOrdering);
+    }
+
+    void setQuiescence(const std::string &mode)
+    {
+        if (mode == QUIESCENCE_OFF)
+        {
+            quiescenceMode = QuiescenceSearch::OFF;
+        }
+        else if (mode == QUIESCENCE_CAPTURES)
+        {
+            quiescenceMode = QuiescenceSearch::CAPTURES;
+        }
+        else if (mode == QUIESCENCE_CHECK_EVASIONS)
+        {
+            quiescenceMode = QuiescenceSearch::CHECK_EVASIONS;
+        }
+        else
+        {
+            std::cerr << "Error: Invalid quiescence mode: " << mode << std::endl;
+            abort(); // Invalid mode
+        }
+        moveStrategy->setQuiescenceMode(quiescenceMode);
+    }
+
+    void setMoveOrdering(const std::string &mode)
+    {
+        if (mode == MOVE_ORDERING_ON)
+        {
+            moveOrdering = true;
+        }
+        else if (mode == MOVE_ORDERING_OFF)
+        {
+            moveOrdering = false;
+        }
+        else
+        {
+            std::cerr << "Error: Invalid move ordering: " << mode << std::endl;
+            abort(); // Invalid mode
+        }
+        moveStrategy->setMoveOrdering(moveOrdering);
+    }
+
+    void setSmpMode(const std::string &mode)
+    {
+        if (mode == SMP_DEPTH_SPLIT)
+        {
+            lazySmp = false;
+        }
+        else if (mode == SMP_LAZY)
+        {
+            lazySmp = true;
+        }
+        else
+        {
+            std::cerr << "Error: Invalid SMP mode: " << mode << std::endl;
+            abort(); // Invalid mode
+        }
     }
 
     void setEvalStrategy(const std::string &strategy)
@@ -138,7 +231,7 @@ public:
 
     std::vector<std::string> listMoveStrategies()
     {
-        return {RANDOM_STRATEGY, BEST_EVAL_MOVE_STRATEGY};
+        return {RANDOM_STRATEGY, BEST_EVAL_MOVE_STRATEGY, PVS_STRATEGY};
     }
 
     std::vector<std::string> listEvalStrategies()
@@ -154,7 +247,7 @@ public:
 
     short getCheckmate()
     {
-        if (botLogic.isInCheck(isWhiteTurn) && botLogic.getLegalMoves(isWhiteTurn).empty())
+        if (botLogic.isInCheck(isWhiteTurn) && !hasLegalMove())
         {
             return isWhiteTurn ? 2 : 1; // 2 for black wins, 1 for white wins
         }
@@ -163,6 +256,9 @@ public:
 
     bool isStaleMate();
 
+    // returns 1 if a check, 2 if white wins, 3 if black wins, 4 if draw, 0 if no result
+    short getGameResult();
+
     std::vector<ChessLogic::Move> getMoveHistory() const;
 
     std::vector<std::string> translateMoveHistory() const;
@@ -181,20 +277,70 @@ public:
 
     std::string getAvailableMoves();
 
+    // Perft report for the current position: node count, time and nodes per second
+    std::string perft(short depth);
+
+    // Parallel perft, the moves two plies deep are shared out between threads. hashSizeMB 0 disables the perft hash
+    std::string perft(short depth, short threadCount, int hashSizeMB);
+
+    // Node count below each root move followed by the perft report
+    std::string divide(short depth);
+
+    // Static exchange evaluation of a move given as a string like "e4d5", in centipawns for the side making it
+    int see(const std::string &move) const;
+
+    // Whether a move given as a string like "e1g1" checks the opponent king, without making it
+    bool givesCheck(const std::string &move) const;
+
+    // Passes the turn the way the search does for null move pruning, the side to move must not be in check
+    void applyNullMove();
+
+    // Takes back the null move made last, ignored when the last move was a real one
+    void undoNullMove();
+
+    // Zobrist key of the current position
+    uint64_t getPositionKey() const;
+
+    // Earlier occurrences of the current position, counted back to the last irreversible move or null move
+    int getRepetitionCount() const;
+
+    // Perft of the current position with each slider backend the CPU supports, the backend the search uses never changes
+    std::string benchSliderBackends(short depth);
+
     const std::string whosTurn() const;
 
 protected:
     bool isWhiteTurn = true;
 
-    int halfMoveClock = 0;
     int fullMoveNumber = 1;
 
     std::string currentMoveStrategy;
     std::string currentEvalStrategy;
+    short quiescenceMode = QuiescenceSearch::CHECK_EVASIONS;
+    bool lazySmp = true;
+    bool moveOrdering = true;
     ;
 
     ChessLogic botLogic;
     ;
+
+    // Every move played since the last setFEN, the undo history of botLogic only keeps the latest ones
+    std::vector<ChessLogic::Move> gameMoves;
+
+    static const int DEFAULT_HASH_SIZE_MB = 16;
+
+    // Kept between moves so each search starts with what the previous ones learned
+    TranspositionTable transpositionTable{DEFAULT_HASH_SIZE_MB};
+
+    std::string perftReport(uint64_t nodes, long long microseconds) const;
+
+    // Whether the side to move has a legal move, remembered for the last position key asked about.
+    // The UI polls the game result after every ply, so repeated polls of one position never generate moves
+    bool hasLegalMove();
+
+    bool legalMoveCacheValid = false;
+    uint64_t legalMoveCacheKey = 0;
+    bool cachedHasLegalMove = false;
 };
 
 #endif
\ No newline at end of file
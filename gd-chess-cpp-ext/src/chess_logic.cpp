@@ -1,4 +1,5 @@
 #include "chess_logic.h"
+#include "attack_tables.h"
 
 short ChessLogic::getSqureTopLeft(short square) const {
     return (square % 8 != 0 && square >= 8) ? square - 9 : -1;
@@ -46,37 +47,37 @@ short ChessLogic::getSqureXYrelative(short square, short x, short y) const {
 
 bool ChessLogic::isMovePsuedoLegal(const Move &move) const {
     // Ensure the move is within bounds
-    if (move.from < 0 || move.from >= 64 || move.to < 0 || move.to >= 64) {
+    if (move.from() < 0 || move.from() >= 64 || move.to() < 0 || move.to() >= 64) {
         return false;
     }
 
     // Ensure the piece being moved belongs to the correct player
-    if (internalBoard[move.from].color != move.color) {
+    if (internalBoard[move.from()].color != move.color()) {
         return false;
     }
 
     // Ensure the destination square is not occupied by the same color
-    if (internalBoard[move.to].color == move.color) {
+    if (internalBoard[move.to()].color == move.color()) {
         return false;
     }
 
     // Handle pawn moves
-    if (move.piece == 1) { // Pawn
-        short direction = (move.color == 1) ? -8 : 8; // White moves up, Black moves down
-        if (move.to == move.from + direction) { // Single square forward
-            if (internalBoard[move.to].type != 0) {
+    if (move.piece() == 1) { // Pawn
+        short direction = (move.color() == 1) ? -8 : 8; // White moves up, Black moves down
+        if (move.to() == move.from() + direction) { // Single square forward
+            if (internalBoard[move.to()].type != 0) {
                 return false; // Cannot move forward into an occupied square
             }
-        } else if (move.to == move.from + 2 * direction) { // Double square forward
-            if ((move.color == 1 && move.from / 8 != 6) || (move.color == 2 && move.from / 8 != 1)) {
+        } else if (move.to() == move.from() + 2 * direction) { // Double square forward
+            if ((move.color() == 1 && move.from() / 8 != 6) || (move.color() == 2 && move.from() / 8 != 1)) {
                 return false; // Double move only allowed from starting rank
             }
-            if (internalBoard[move.to].type != 0 || internalBoard[move.from + direction].type != 0) {
+            if (internalBoard[move.to()].type != 0 || internalBoard[move.from() + direction].type != 0) {
                 return false; // Path must be clear
             }
-        } else if ((move.to == move.from + direction - 1 && move.from % 8 != 0) || (move.to == move.from + direction + 1 && move.from % 8 != 7)) { // Diagonal capture
-            if (internalBoard[move.to].type == 0) {
-                if (move.to != enPassantSquare || move.moveType != 3) {
+        } else if ((move.to() == move.from() + direction - 1 && move.from() % 8 != 0) || (move.to() == move.from() + direction + 1 && move.from() % 8 != 7)) { // Diagonal capture
+            if (internalBoard[move.to()].type == 0) {
+                if (move.to() != enPassantSquare || move.moveType() != 3) {
                     return false; // Must capture a piece or be a valid en passant move
                 }
             }
@@ -86,26 +87,26 @@ bool ChessLogic::isMovePsuedoLegal(const Move &move) const {
     }
 
     // Handle knight moves
-    if (move.piece == 2) { // Knight
-        short dx = abs((move.from % 8) - (move.to % 8));
-        short dy = abs((move.from / 8) - (move.to / 8));
+    if (move.piece() == 2) { // Knight
+        short dx = abs((move.from() % 8) - (move.to() % 8));
+        short dy = abs((move.from() / 8) - (move.to() / 8));
         if (!(dx == 2 && dy == 1) && !(dx == 1 && dy == 2)) {
             return false; // Knights move in an "L" shape
         }
     }
 
     // Handle bishop moves
-    if (move.piece == 3) { // Bishop
-        short dx = abs((move.from % 8) - (move.to % 8));
-        short dy = abs((move.from / 8) - (move.to / 8));
+    if (move.piece() == 3) { // Bishop
+        short dx = abs((move.from() % 8) - (move.to() % 8));
+        short dy = abs((move.from() / 8) - (move.to() / 8));
         if (dx != dy) {
             return false; // Bishops move diagonally
         }
         // Ensure path is clear
-        short stepX = (move.to % 8 > move.from % 8) ? 1 : -1;
-        short stepY = (move.to / 8 > move.from / 8) ? 1 : -1;
-        for (short x = move.from % 8 + stepX, y = move.from / 8 + stepY;
-             x != move.to % 8 && y != move.to / 8; x += stepX, y += stepY) {
+        short stepX = (move.to() % 8 > move.from() % 8) ? 1 : -1;
+        short stepY = (move.to() / 8 > move.from() / 8) ? 1 : -1;
+        for (short x = move.from() % 8 + stepX, y = move.from() / 8 + stepY;
+             x != move.to() % 8 && y != move.to() / 8; x += stepX, y += stepY) {
             if (internalBoard[y * 8 + x].type != 0) {
                 return false;
             }
@@ -113,14 +114,14 @@ bool ChessLogic::isMovePsuedoLegal(const Move &move) const {
     }
 
     // Handle rook moves
-    if (move.piece == 4) { // Rook
-        if (move.from % 8 != move.to % 8 && move.from / 8 != move.to / 8) {
+    if (move.piece() == 4) { // Rook
+        if (move.from() % 8 != move.to() % 8 && move.from() / 8 != move.to() / 8) {
             return false; // Rooks move in straight lines
         }
         // Ensure path is clear
-        short step = (move.from % 8 == move.to % 8) ? 8 : 1;
-        short start = std::min(move.from, move.to) + step;
-        short end = std::max(move.from, move.to);
+        short step = (move.from() % 8 == move.to() % 8) ? 8 : 1;
+        short start = std::min(move.from(), move.to()) + step;
+        short end = std::max(move.from(), move.to());
         for (short i = start; i < end; i += step) {
             if (internalBoard[i].type != 0) {
                 return false;
@@ -129,26 +130,26 @@ bool ChessLogic::isMovePsuedoLegal(const Move &move) const {
     }
 
     // Handle queen moves
-    if (move.piece == 5) { // Queen
-        short dx = abs((move.from % 8) - (move.to % 8));
-        short dy = abs((move.from / 8) - (move.to / 8));
-        if (dx != dy && move.from % 8 != move.to % 8 && move.from / 8 != move.to / 8) {
+    if (move.piece() == 5) { // Queen
+        short dx = abs((move.from() % 8) - (move.to() % 8));
+        short dy = abs((move.from() / 8) - (move.to() / 8));
+        if (dx != dy && move.from() % 8 != move.to() % 8 && move.from() / 8 != move.to() / 8) {
             return false; // Queens move diagonally or in straight lines
         }
         // Ensure path is clear (reuse bishop and rook logic)
         if (dx == dy) { // Diagonal move
-            short stepX = (move.to % 8 > move.from % 8) ? 1 : -1;
-            short stepY = (move.to / 8 > move.from / 8) ? 1 : -1;
-            for (short x = move.from % 8 + stepX, y = move.from / 8 + stepY;
-                 x != move.to % 8 && y != move.to / 8; x += stepX, y += stepY) {
+            short stepX = (move.to() % 8 > move.from() % 8) ? 1 : -1;
+            short stepY = (move.to() / 8 > move.from() / 8) ? 1 : -1;
+            for (short x = move.from() % 8 + stepX, y = move.from() / 8 + stepY;
+                 x != move.to() % 8 && y != move.to() / 8; x += stepX, y += stepY) {
                 if (internalBoard[y * 8 + x].type != 0) {
                     return false;
                 }
             }
         } else { // Straight line move
-            short step = (move.from % 8 == move.to % 8) ? 8 : 1;
-            short start = std::min(move.from, move.to) + step;
-            short end = std::max(move.from, move.to);
+            short step = (move.from() % 8 == move.to() % 8) ? 8 : 1;
+            short start = std::min(move.from(), move.to()) + step;
+            short end = std::max(move.from(), move.to());
             for (short i = start; i < end; i += step) {
                 if (internalBoard[i].type != 0) {
                     return false;
@@ -158,32 +159,32 @@ bool ChessLogic::isMovePsuedoLegal(const Move &move) const {
     }
 
     // Handle king moves
-    if (move.piece == 6) { // King
-        short dx = abs((move.from % 8) - (move.to % 8));
-        short dy = abs((move.from / 8) - (move.to / 8));
+    if (move.piece() == 6) { // King
+        short dx = abs((move.from() % 8) - (move.to() % 8));
+        short dy = abs((move.from() / 8) - (move.to() / 8));
         if (dx > 1 || dy > 1) {
             return false; // Kings move one square in any direction
         }
         // Handle castling
-        if (move.moveType == 1 || move.moveType == 2) { // Castling
+        if (move.moveType() == 1 || move.moveType() == 2) { // Castling
             // Ensure the path is clear and the rook is in the correct position
-            short rookSquare = (move.moveType == 1) ? move.from + 3 : move.from - 4;
-            short step = (move.moveType == 1) ? 1 : -1;
+            short rookSquare = (move.moveType() == 1) ? move.from() + 3 : move.from() - 4;
+            short step = (move.moveType() == 1) ? 1 : -1;
 
             // Check castling rights
-            if ((move.color == 1 && move.moveType == 1 && !whiteKCastle) || 
-                (move.color == 1 && move.moveType == 2 && !whiteQCastle) || 
-                (move.color == 2 && move.moveType == 1 && !blackKCastle) || 
-                (move.color == 2 && move.moveType == 2 && !blackQCastle)) {
+            if ((move.color() == 1 && move.moveType() == 1 && !whiteKCastle) || 
+                (move.color() == 1 && move.moveType() == 2 && !whiteQCastle) || 
+                (move.color() == 2 && move.moveType() == 1 && !blackKCastle) || 
+                (move.color() == 2 && move.moveType() == 2 && !blackQCastle)) {
                 return false; // Castling not allowed
             }
 
-            for (short i = move.from + step; i != rookSquare; i += step) {
+            for (short i = move.from() + step; i != rookSquare; i += step) {
                 if (internalBoard[i].type != 0) {
                     return false; // Path must be clear
                 }
             }
-            if (internalBoard[rookSquare].type != 4 || internalBoard[rookSquare].color != move.color) {
+            if (internalBoard[rookSquare].type != 4 || internalBoard[rookSquare].color != move.color()) {
                 return false; // Rook must be in the correct position
             }
         }
@@ -193,23 +194,60 @@ bool ChessLogic::isMovePsuedoLegal(const Move &move) const {
 }
 
 uint64_t ChessLogic::getPieceBitBoard(short color, short piece) const {
-    uint64_t bitboard = 0;
-    for (short i = 0; i < 64; ++i) {
-        if (internalBoard[i].color == color && internalBoard[i].type == piece) {
-            bitboard |= (1ULL << i);
-        }
-    }
-    return bitboard;
+    return pieceBitBoards[color][piece];
 }
 
 uint64_t ChessLogic::getColorBitBoard(short color) const {
-    uint64_t bitboard = 0;
+    return colorBitBoards[color];
+}
+
+uint64_t ChessLogic::getOccupiedBitBoard() const {
+    return colorBitBoards[1] | colorBitBoards[2];
+}
+
+void ChessLogic::putPiece(short square, const chessPiece &piece) {
+    internalBoard[square] = piece;
+    uint64_t squareBit = 1ULL << square;
+    colorBitBoards[piece.color] |= squareBit;
+    pieceBitBoards[piece.color][piece.type] |= squareBit;
+    if (piece.type == 6) {
+        kingSquares[piece.color] = square;
+    }
+    positionKey ^= ZOBRIST.pieces[piece.color][piece.type][square];
+}
+
+void ChessLogic::removePiece(short square) {
+    chessPiece &piece = internalBoard[square];
+    uint64_t squareMask = ~(1ULL << square);
+    colorBitBoards[piece.color] &= squareMask;
+    pieceBitBoards[piece.color][piece.type] &= squareMask;
+    if (piece.type == 6) {
+        kingSquares[piece.color] = -1;
+    }
+    positionKey ^= ZOBRIST.pieces[piece.color][piece.type][square]; // zero for an empty square
+    piece = {0, 0};
+}
+
+void ChessLogic::movePiece(short fromSquare, short toSquare) {
+    chessPiece piece = internalBoard[fromSquare];
+    removePiece(fromSquare);
+    putPiece(toSquare, piece);
+}
+
+void ChessLogic::refreshBitBoards() {
+    for (short color = 0; color < 3; ++color) {
+        colorBitBoards[color] = 0;
+        for (short type = 0; type < 7; ++type) {
+            pieceBitBoards[color][type] = 0;
+        }
+        kingSquares[color] = -1;
+    }
     for (short i = 0; i < 64; ++i) {
-        if (internalBoard[i].color == color) {
-            bitboard |= (1ULL << i);
+        if (internalBoard[i].type != 0) {
+            putPiece(i, internalBoard[i]);
         }
     }
-    return bitboard;
+    positionKey = hashPosition(whiteToMove);
 }
 
 ChessLogic::ChessLogic() {
@@ -218,22 +256,24 @@ ChessLogic::ChessLogic() {
     for (int i = 0; i < 64; ++i) {
         internalBoard[i] = {0, 0}; // Empty piece
     }
+    refreshBitBoards();
 }
 
-ChessLogic::ChessLogic(chessPiece (&board)[], std::stack<Move> moveStack, std::stack<castleRights> castleStack, 
-    bool wKC, bool wQC, bool bKC, bool bQC, int ePSq) {
-        for (int i = 0; i < 64; i++) {
-            this->internalBoard[i] = chessPiece(board[i].color, board[i].type);
-        }
-        this->whiteKCastle = wKC;
-        this->whiteQCastle = wQC;
-        this->blackQCastle = bQC;
-        this->blackKCastle = bKC;
-        this->enPassantSquare = ePSq;
+ChessLogic::ChessLogic(const ChessPosition &position) : ChessPosition(position) {
+}
+
+const ChessPosition &ChessLogic::getPosition() const {
+    return *this;
+}
 
-        this->moveStack = moveStack;
-        this->castleStack = castleStack;
+bool ChessLogic::setSliderBackend(short backend) {
+    const AttackTables::sliderTables *tables = AttackTables::getTables(backend);
+    if (tables == nullptr) {
+        return false;
     }
+    sliders = tables;
+    return true;
+}
 
 ChessLogic::~ChessLogic() {
     // Destructor logic if needed
@@ -243,277 +283,852 @@ void ChessLogic::copyChessBoard(const chessPiece inputBoard[64]) {
     for (int i = 0; i < 64; ++i) {
         internalBoard[i] = inputBoard[i];
     }
+    refreshBitBoards();
 }
 
-std::vector<ChessLogic::Move> ChessLogic::getLegalMoves(bool isWhite) {
-    std::vector<Move> pseudoMoves;
-    short color = isWhite ? 1 : 2;
-    short opponentColor = isWhite ? 2 : 1;
+ChessLogic::MoveList ChessLogic::getLegalMoves(bool isWhite) {
+    MoveList legalMoves;
+    generateLegalMoves(isWhite ? 1 : 2, legalMoves);
+    return legalMoves;
+}
 
-    uint64_t colorBitboard = getColorBitBoard(color);
-    std::vector<short> fromSquares = bitboardToSquares(colorBitboard); // own squares
-    std::vector<short> toSquares = bitboardToSquares(
-        getPawnMoveBitBoard(color) | getKnightMoveBitBoard(color) | getBishopMoveBitBoard(color) |
-        getRookMoveBitBoard(color) | getKingMoveBitBoard(color)
-    ); 
-    
-    for (short i = 0; i < fromSquares.size() ; ++i) {
-        
-        if (internalBoard[fromSquares.at(i)].color == color) {
-            for (short j = 0; j < toSquares.size(); ++j) {
-
-                Move move = translateMove(fromSquares.at(i), toSquares.at(j));
-
-                if (isMovePsuedoLegal(move)) {
-
-                    if (move.piece == 1) { // add promotions
-                        if ((move.color == 1 && move.to / 8 == 7) || (move.color == 2 && move.to / 8 == 0)) {
-                            Move queenPromo = Move(move);
-                            queenPromo.promotion = 5;
-                            Move rookPromo = Move(move);
-                            rookPromo.promotion = 4;
-                            Move bishopPromo = Move(move);
-                            bishopPromo.promotion = 3;
-                            Move kightPromo = Move(move);
-                            kightPromo.promotion = 2;
-                            pseudoMoves.push_back(queenPromo);
-                            pseudoMoves.push_back(rookPromo);
-                            pseudoMoves.push_back(bishopPromo);
-                            pseudoMoves.push_back(kightPromo);
-                        } else {
-
-                            pseudoMoves.push_back(move); // normal pawn move
-                        }
-
-                    } else {
-                        pseudoMoves.push_back(move);
-                    }
-                    
+ChessLogic::legalMoveMasks ChessLogic::getLegalMoveMasks(short color) const {
+    return (color == WHITE) ? getLegalMoveMasks<WHITE>() : getLegalMoveMasks<BLACK>();
+}
+
+template<short color>
+ChessLogic::legalMoveMasks ChessLogic::getLegalMoveMasks() const {
+    constexpr short opponentColor = (color == WHITE) ? BLACK : WHITE;
+    legalMoveMasks masks;
+    uint64_t occupied = getOccupiedBitBoard();
+    uint64_t kingBitboard = pieceBitBoards[color][6];
+
+    // squares the king cannot step on, computed without the king so it cannot retreat along a checking ray
+    masks.attacked = getAttackedSquares<opponentColor>(occupied & ~kingBitboard);
+
+    if (kingBitboard == 0) {
+        return masks; // No king on the board, nothing to protect
+    }
+    masks.kingSquare = kingSquares[color];
+    masks.checkers = attackersTo(masks.kingSquare, occupied) & colorBitBoards[opponentColor];
+
+    uint64_t queens = pieceBitBoards[opponentColor][5];
+    uint64_t diagonalSliders = pieceBitBoards[opponentColor][3] | queens;
+    uint64_t straightSliders = pieceBitBoards[opponentColor][4] | queens;
+
+    // Sliders that see the king through own pieces only, a single own blocker in between is pinned
+    uint64_t opponentPieces = colorBitBoards[opponentColor];
+    uint64_t snipers = (sliders->bishopAttacks(masks.kingSquare, opponentPieces) & diagonalSliders)
+        | (sliders->rookAttacks(masks.kingSquare, opponentPieces) & straightSliders);
+    while (snipers) {
+        short sniperSquare = popLeastSignificantBit(snipers);
+        uint64_t blockers = AttackTables::between(masks.kingSquare, sniperSquare) & occupied;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & colorBitBoards[color])) {
+            masks.pinned |= blockers;
+        }
+    }
+
+    // In single check a move must capture the checker or block its ray, in double check only the king moves
+    if (masks.checkers) {
+        if (masks.checkers & (masks.checkers - 1)) {
+            masks.evasionMask = 0;
+        } else {
+            masks.evasionMask = masks.checkers | AttackTables::between(masks.kingSquare, bitScanForward(masks.checkers));
+        }
+    }
+
+    return masks;
+}
+
+uint64_t ChessLogic::attackersTo(short square, uint64_t occupied) const {
+    uint64_t queens = pieceBitBoards[1][5] | pieceBitBoards[2][5];
+    uint64_t diagonalSliders = pieceBitBoards[1][3] | pieceBitBoards[2][3] | queens;
+    uint64_t straightSliders = pieceBitBoards[1][4] | pieceBitBoards[2][4] | queens;
+
+    // a white pawn attacks the square from where a black pawn on it would capture, and the other way round
+    return (AttackTables::pawnAttacks(square, 2) & pieceBitBoards[1][1])
+        | (AttackTables::pawnAttacks(square, 1) & pieceBitBoards[2][1])
+        | (AttackTables::knightAttacks(square) & (pieceBitBoards[1][2] | pieceBitBoards[2][2]))
+        | (AttackTables::kingAttacks(square) & (pieceBitBoards[1][6] | pieceBitBoards[2][6]))
+        | (sliders->bishopAttacks(square, occupied) & diagonalSliders)
+        | (sliders->rookAttacks(square, occupied) & straightSliders);
+}
+
+bool ChessLogic::isSquareAttacked(short square, short byColor, uint64_t occupied) const {
+    return attackersTo(square, occupied) & colorBitBoards[byColor];
+}
+
+ChessLogic::checkInfo ChessLogic::getCheckInfo(short color) const {
+    checkInfo info;
+    short opponentColor = (color == WHITE) ? BLACK : WHITE;
+    info.kingSquare = kingSquares[opponentColor];
+    if (info.kingSquare == -1) {
+        return info;
+    }
+
+    uint64_t occupied = getOccupiedBitBoard();
+    // a pawn of color checks the king from where an opponent pawn on the king square would capture
+    info.checkSquares[1] = AttackTables::pawnAttacks(info.kingSquare, opponentColor);
+    info.checkSquares[2] = AttackTables::knightAttacks(info.kingSquare);
+    info.checkSquares[3] = sliders->bishopAttacks(info.kingSquare, occupied);
+    info.checkSquares[4] = sliders->rookAttacks(info.kingSquare, occupied);
+    info.checkSquares[5] = info.checkSquares[3] | info.checkSquares[4];
+
+    // own sliders lined up with the king behind exactly one own piece
+    uint64_t queens = pieceBitBoards[color][5];
+    uint64_t snipers = (sliders->bishopAttacks(info.kingSquare, 0) & (pieceBitBoards[color][3] | queens))
+        | (sliders->rookAttacks(info.kingSquare, 0) & (pieceBitBoards[color][4] | queens));
+    while (snipers) {
+        short sniperSquare = popLeastSignificantBit(snipers);
+        uint64_t blockers = AttackTables::between(info.kingSquare, sniperSquare) & occupied;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & colorBitBoards[color])) {
+            info.discoveredCandidates |= blockers;
+        }
+    }
+    return info;
+}
+
+bool ChessLogic::givesCheck(const Move &move) const {
+    return givesCheck(move, getCheckInfo(move.color()));
+}
+
+bool ChessLogic::givesCheck(const Move &move, const checkInfo &info) const {
+    if (info.kingSquare == -1) {
+        return false;
+    }
+    short fromSquare = move.from();
+    short toSquare = move.to();
+    uint64_t kingBit = 1ULL << info.kingSquare;
+
+    // direct check, a promoted piece is tested below because its rays can run back through the square it left
+    if (!move.promotion() && (info.checkSquares[move.piece()] & (1ULL << toSquare))) {
+        return true;
+    }
+
+    // discovered check, unless the piece stays on the line between the slider and the king
+    if ((info.discoveredCandidates & (1ULL << fromSquare)) && !(AttackTables::line(info.kingSquare, fromSquare) & (1ULL << toSquare))) {
+        return true;
+    }
+
+    short color = move.color();
+    uint64_t occupied = getOccupiedBitBoard() ^ (1ULL << fromSquare);
+    switch (move.moveType()) {
+        case 1:   // Kingside castling, the rook lands next to the king
+        case 2: { // Queenside castling
+            short rookFrom = (move.moveType() == 1) ? toSquare + 1 : toSquare - 2;
+            short rookTo = (move.moveType() == 1) ? toSquare - 1 : toSquare + 1;
+            occupied = (occupied ^ (1ULL << rookFrom)) | (1ULL << toSquare) | (1ULL << rookTo);
+            return sliders->rookAttacks(rookTo, occupied) & kingBit;
+        }
+        case 3: { // En passant, removing both pawns from the rank can uncover a slider
+            short capturedPawnSquare = (color == WHITE) ? toSquare + 8 : toSquare - 8;
+            occupied = (occupied ^ (1ULL << capturedPawnSquare)) | (1ULL << toSquare);
+            uint64_t queens = pieceBitBoards[color][5];
+            return (sliders->bishopAttacks(info.kingSquare, occupied) & (pieceBitBoards[color][3] | queens))
+                || (sliders->rookAttacks(info.kingSquare, occupied) & (pieceBitBoards[color][4] | queens));
+        }
+    }
+
+    if (move.promotion()) {
+        occupied |= 1ULL << toSquare;
+        switch (move.promotion()) {
+            case 2: return AttackTables::knightAttacks(toSquare) & kingBit;
+            case 3: return sliders->bishopAttacks(toSquare, occupied) & kingBit;
+            case 4: return sliders->rookAttacks(toSquare, occupied) & kingBit;
+            case 5: return sliders->queenAttacks(toSquare, occupied) & kingBit;
+        }
+    }
+    return false;
+}
+
+short ChessLogic::leastValuableAttacker(uint64_t attackers, short color, uint64_t &attackerBit) const {
+    for (short piece = 1; piece <= 6; ++piece) {
+        uint64_t pieces = attackers & pieceBitBoards[color][piece];
+        if (pieces) {
+            attackerBit = pieces & (0 - pieces);
+            return piece;
+        }
+    }
+    return 0;
+}
+
+int ChessLogic::see(const Move &move) const {
+    if (move.moveType() == 1 || move.moveType() == 2) {
+        return 0; // castling never captures
+    }
+
+    short toSquare = move.to();
+    uint64_t occupied = getOccupiedBitBoard();
+    uint64_t queens = pieceBitBoards[1][5] | pieceBitBoards[2][5];
+    uint64_t diagonalSliders = pieceBitBoards[1][3] | pieceBitBoards[2][3] | queens;
+    uint64_t straightSliders = pieceBitBoards[1][4] | pieceBitBoards[2][4] | queens;
+
+    if (move.moveType() == 3) { // the pawn taken en passant is not on the target square
+        occupied ^= 1ULL << (move.color() == WHITE ? toSquare + 8 : toSquare - 8);
+    }
+
+    // gain[d] is the balance for the side making capture d, before its piece can be taken back
+    int gain[32];
+    int d = 0;
+    gain[0] = SEE_VALUES[move.capture()];
+    int targetValue = SEE_VALUES[move.piece()]; // value of the piece now standing on the target square
+    if (move.promotion()) {
+        gain[0] += SEE_VALUES[move.promotion()] - SEE_VALUES[1];
+        targetValue = SEE_VALUES[move.promotion()];
+    }
+
+    uint64_t attackerBit = 1ULL << move.from();
+    uint64_t attackers = attackersTo(toSquare, occupied);
+    short side = move.color();
+    while (d < 31) {
+        // removing the piece that just captured uncovers the sliders behind it
+        occupied ^= attackerBit;
+        attackers |= (sliders->bishopAttacks(toSquare, occupied) & diagonalSliders)
+            | (sliders->rookAttacks(toSquare, occupied) & straightSliders);
+        attackers &= occupied;
+
+        side = (side == WHITE) ? BLACK : WHITE;
+        short piece = leastValuableAttacker(attackers, side, attackerBit);
+        if (piece == 0) {
+            break;
+        }
+        if (piece == 6 && (attackers & colorBitBoards[side == WHITE ? BLACK : WHITE])) {
+            break; // the king cannot capture onto a defended square
+        }
+
+        ++d;
+        gain[d] = targetValue - gain[d - 1];
+        targetValue = SEE_VALUES[piece];
+    }
+
+    // walk back down the list, each side only recaptures when that beats stopping
+    for (; d > 0; --d) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    }
+    return gain[0];
+}
+
+bool ChessLogic::seeGE(const Move &move, int threshold) const {
+    if (move.moveType() == 1 || move.moveType() == 2) {
+        return 0 >= threshold;
+    }
+
+    short toSquare = move.to();
+    int movedValue = move.promotion() ? SEE_VALUES[move.promotion()] : SEE_VALUES[move.piece()];
+    int promotionGain = move.promotion() ? SEE_VALUES[move.promotion()] - SEE_VALUES[1] : 0;
+
+    // swap is what the side to move in the loop has to win back to flip the result
+    int swap = SEE_VALUES[move.capture()] + promotionGain - threshold;
+    if (swap < 0) {
+        return false; // even an undefended target does not reach the threshold
+    }
+    swap = movedValue - swap;
+    if (swap <= 0) {
+        return true; // losing the moved piece for nothing still reaches it
+    }
+
+    uint64_t occupied = getOccupiedBitBoard() ^ (1ULL << move.from()) ^ (1ULL << toSquare);
+    if (move.moveType() == 3) {
+        occupied ^= 1ULL << (move.color() == WHITE ? toSquare + 8 : toSquare - 8);
+    }
+    uint64_t queens = pieceBitBoards[1][5] | pieceBitBoards[2][5];
+    uint64_t diagonalSliders = pieceBitBoards[1][3] | pieceBitBoards[2][3] | queens;
+    uint64_t straightSliders = pieceBitBoards[1][4] | pieceBitBoards[2][4] | queens;
+    uint64_t attackers = attackersTo(toSquare, occupied) & occupied;
+
+    short side = move.color();
+    bool result = true;
+    while (true) {
+        side = (side == WHITE) ? BLACK : WHITE;
+        attackers &= occupied;
+        uint64_t attackerBit = 0;
+        short piece = leastValuableAttacker(attackers, side, attackerBit);
+        if (piece == 0) {
+            break;
+        }
+
+        // the king can only take last, if the other side still has an attacker the capture is illegal
+        if (piece == 6) {
+            return (attackers & colorBitBoards[side == WHITE ? BLACK : WHITE]) ? result : !result;
+        }
+
+        // after this capture the side that made it keeps the result unless the balance still tips the other way
+        result = !result;
+        swap = SEE_VALUES[piece] - swap;
+        if (swap < int(result)) {
+            break;
+        }
+        occupied ^= attackerBit;
+        if (piece == 1 || piece == 3 || piece == 5) {
+            attackers |= sliders->bishopAttacks(toSquare, occupied) & diagonalSliders;
+        }
+        if (piece == 4 || piece == 5) {
+            attackers |= sliders->rookAttacks(toSquare, occupied) & straightSliders;
+        }
+    }
+    return result;
+}
+
+uint64_t ChessLogic::getAttackedSquares(short color, uint64_t occupied) const {
+    return (color == WHITE) ? getAttackedSquares<WHITE>(occupied) : getAttackedSquares<BLACK>(occupied);
+}
+
+template<short color>
+uint64_t ChessLogic::getAttackedSquares(uint64_t occupied) const {
+    uint64_t attacks = AttackTables::allPawnAttacks(pieceBitBoards[color][1], color);
+
+    uint64_t knights = pieceBitBoards[color][2];
+    while (knights) {
+        attacks |= AttackTables::knightAttacks(popLeastSignificantBit(knights));
+    }
+    uint64_t diagonalSliders = pieceBitBoards[color][3] | pieceBitBoards[color][5];
+    while (diagonalSliders) {
+        attacks |= sliders->bishopAttacks(popLeastSignificantBit(diagonalSliders), occupied);
+    }
+    uint64_t straightSliders = pieceBitBoards[color][4] | pieceBitBoards[color][5];
+    while (straightSliders) {
+        attacks |= sliders->rookAttacks(popLeastSignificantBit(straightSliders), occupied);
+    }
+    uint64_t kings = pieceBitBoards[color][6];
+    while (kings) {
+        attacks |= AttackTables::kingAttacks(popLeastSignificantBit(kings));
+    }
+
+    return attacks;
+}
+
+void ChessLogic::generateLegalMoves(short color, MoveList &moves) const {
+    generateLegalMoves(color, moves, ALL_MOVES, getLegalMoveMasks(color));
+}
+
+void ChessLogic::generateLegalMoves(short color, MoveList &moves, short moveKind, const legalMoveMasks &masks) const {
+    if (color == WHITE) {
+        generateLegalMoves<WHITE>(moves, moveKind, masks);
+    } else {
+        generateLegalMoves<BLACK>(moves, moveKind, masks);
+    }
+}
+
+template<short color>
+void ChessLogic::generateLegalMoves(MoveList &moves, short moveKind, const legalMoveMasks &masks) const {
+    constexpr short opponentColor = (color == WHITE) ? BLACK : WHITE;
+    uint64_t ownPieces = colorBitBoards[color];
+    uint64_t occupied = getOccupiedBitBoard();
+
+    // squares a piece may land on for the requested kind
+    uint64_t kindTargets = ~ownPieces;
+    if (moveKind == CAPTURE_MOVES) {
+        kindTargets = colorBitBoards[opponentColor];
+    } else if (moveKind == QUIET_MOVES) {
+        kindTargets = ~occupied;
+    }
+
+    // Double check, only the king evasions below can be legal
+    bool doubleCheck = masks.checkers & (masks.checkers - 1);
+
+    if (!doubleCheck) {
+        generatePawnMoves<color>(moveKind, masks, moves);
+
+        // Knights and sliders read their targets straight from the attack sets, pinned pieces stay on the pin line
+        for (short piece = 2; piece <= 5; ++piece) {
+            uint64_t pieces = pieceBitBoards[color][piece];
+            while (pieces) {
+                short fromSquare = popLeastSignificantBit(pieces);
+                uint64_t targets = 0;
+                switch (piece) {
+                    case 2: targets = AttackTables::knightAttacks(fromSquare); break;
+                    case 3: targets = sliders->bishopAttacks(fromSquare, occupied); break;
+                    case 4: targets = sliders->rookAttacks(fromSquare, occupied); break;
+                    case 5: targets = sliders->queenAttacks(fromSquare, occupied); break;
+                }
+                targets &= kindTargets & masks.evasionMask;
+                if (masks.pinned & (1ULL << fromSquare)) {
+                    targets &= AttackTables::line(masks.kingSquare, fromSquare);
+                }
+                while (targets) {
+                    short toSquare = popLeastSignificantBit(targets);
+                    moves.push_back(Move(fromSquare, toSquare, 0, internalBoard[toSquare].type, color, piece, 0));
                 }
             }
         }
     }
-    // sort moves based on captures and pieces
-    if (pseudoMoves.size() > 8) {
-        std::stable_sort(pseudoMoves.begin(), pseudoMoves.end(), [](ChessLogic::Move a, ChessLogic::Move b) {
-            if (a.capture || b.capture) {
-                return a.capture > b.capture;
+
+    if (masks.kingSquare != -1) {
+        uint64_t targets = AttackTables::kingAttacks(masks.kingSquare) & kindTargets & ~masks.attacked;
+        while (targets) {
+            short toSquare = popLeastSignificantBit(targets);
+            moves.push_back(Move(masks.kingSquare, toSquare, 0, internalBoard[toSquare].type, color, 6, 0));
+        }
+
+        if (!masks.checkers && moveKind != CAPTURE_MOVES) {
+            generateCastlingMoves<color>(masks, moves);
+        }
+    }
+}
+
+bool ChessLogic::hasAnyLegalMove(short color) const {
+    return (color == WHITE) ? hasAnyLegalMove<WHITE>() : hasAnyLegalMove<BLACK>();
+}
+
+template<short color>
+bool ChessLogic::hasAnyLegalMove() const {
+    legalMoveMasks masks = getLegalMoveMasks<color>();
+    uint64_t ownPieces = colorBitBoards[color];
+    uint64_t occupied = getOccupiedBitBoard();
+
+    // castling is never needed: when it is legal the king can also step onto the square next to it
+    if (masks.kingSquare != -1 && (AttackTables::kingAttacks(masks.kingSquare) & ~ownPieces & ~masks.attacked)) {
+        return true;
+    }
+    if (masks.checkers & (masks.checkers - 1)) {
+        return false; // double check and the king cannot move
+    }
+
+    for (short piece = 2; piece <= 5; ++piece) {
+        uint64_t pieces = pieceBitBoards[color][piece];
+        while (pieces) {
+            short fromSquare = popLeastSignificantBit(pieces);
+            uint64_t targets = 0;
+            switch (piece) {
+                case 2: targets = AttackTables::knightAttacks(fromSquare); break;
+                case 3: targets = sliders->bishopAttacks(fromSquare, occupied); break;
+                case 4: targets = sliders->rookAttacks(fromSquare, occupied); break;
+                case 5: targets = sliders->queenAttacks(fromSquare, occupied); break;
+            }
+            targets &= ~ownPieces & masks.evasionMask;
+            if (masks.pinned & (1ULL << fromSquare)) {
+                targets &= AttackTables::line(masks.kingSquare, fromSquare);
             }
-            if (a.piece == 1 && b.piece == 1) {
-               return (a.to % 8 > 2 && a.to % 8 < 5); // flank pawns last 
+            if (targets) {
+                return true;
             }
-            return (a.piece < b.piece && a.piece != 1);
-        });
+        }
     }
 
-    std::vector<Move> legalMoves;
+    // pawns last, they are the only pieces left that need the full generator for pins and en passant
+    MoveList pawnMoves;
+    generatePawnMoves<color>(ALL_MOVES, masks, pawnMoves);
+    return !pawnMoves.empty();
+}
 
-    for (const auto move : pseudoMoves) {
-        if (isMoveLegal(move)) {
-            legalMoves.push_back(move);
+template<short color>
+void ChessLogic::generatePawnMoves(short moveKind, const legalMoveMasks &masks, MoveList &moves) const {
+    constexpr short opponentColor = (color == WHITE) ? BLACK : WHITE;
+    const uint64_t FILE_A = AttackTables::FILE_A;
+    const uint64_t FILE_H = AttackTables::FILE_H;
+
+    uint64_t pawns = pieceBitBoards[color][1];
+    uint64_t emptySquares = ~getOccupiedBitBoard();
+    uint64_t opponentBitboard = colorBitBoards[opponentColor];
+
+    // White pawns move towards square 0, black pawns towards square 63
+    constexpr short forward = (color == WHITE) ? -8 : 8;
+    constexpr uint64_t promotionRank = (color == WHITE) ? 0x00000000000000FFULL : 0xFF00000000000000ULL;
+    constexpr uint64_t doublePushRank = (color == WHITE) ? 0x000000FF00000000ULL : 0x00000000FF000000ULL;
+
+    uint64_t singlePush = shiftForward<color>(pawns) & emptySquares;
+    uint64_t capturesWest = ((color == WHITE) ? (pawns >> 9) : (pawns << 7)) & ~FILE_H & opponentBitboard;
+    uint64_t capturesEast = ((color == WHITE) ? (pawns >> 7) : (pawns << 9)) & ~FILE_A & opponentBitboard;
+    uint64_t doublePush = shiftForward<color>(singlePush) & emptySquares & doublePushRank;
+
+    // promotions by a push count as captures, the rest of the pushes are quiet
+    if (moveKind == CAPTURE_MOVES) {
+        singlePush &= promotionRank;
+        doublePush = 0;
+    } else if (moveKind == QUIET_MOVES) {
+        singlePush &= ~promotionRank;
+        capturesWest = 0;
+        capturesEast = 0;
+    }
+
+    addPawnMoves<color>(singlePush & masks.evasionMask, forward, masks, moves);
+    addPawnMoves<color>(capturesWest & masks.evasionMask, forward - 1, masks, moves);
+    addPawnMoves<color>(capturesEast & masks.evasionMask, forward + 1, masks, moves);
+
+    doublePush &= masks.evasionMask;
+    while (doublePush) {
+        short toSquare = popLeastSignificantBit(doublePush);
+        short fromSquare = toSquare - 2 * forward;
+        if (!isPinnedOffLine(fromSquare, toSquare, masks)) {
+            moves.push_back(Move(fromSquare, toSquare, 0, 0, color, 1, 4));
         }
     }
 
-    return legalMoves;
+    // En passant, the capturing pawns stand where an opponent pawn on the target square would attack
+    if (enPassantSquare != -1 && moveKind != QUIET_MOVES) {
+        uint64_t attackers = AttackTables::pawnAttacks(enPassantSquare, opponentColor) & pawns;
+        while (attackers) {
+            short fromSquare = popLeastSignificantBit(attackers);
+            if (isEnPassantLegal<color>(fromSquare, masks)) {
+                moves.push_back(Move(fromSquare, enPassantSquare, 0, 1, color, 1, 3));
+            }
+        }
+    }
 }
 
-void ChessLogic::makeMove(const Move &move) {
+template<short color>
+void ChessLogic::addPawnMoves(uint64_t targets, short offset, const legalMoveMasks &masks, MoveList &moves) const {
+    constexpr uint64_t promotionRank = (color == WHITE) ? 0x00000000000000FFULL : 0xFF00000000000000ULL;
+    while (targets) {
+        short toSquare = popLeastSignificantBit(targets);
+        short fromSquare = toSquare - offset;
+        if (isPinnedOffLine(fromSquare, toSquare, masks)) {
+            continue;
+        }
+        short capture = internalBoard[toSquare].type;
+        if ((1ULL << toSquare) & promotionRank) { // add promotions
+            for (short promotion = 5; promotion >= 2; --promotion) {
+                moves.push_back(Move(fromSquare, toSquare, promotion, capture, color, 1, 0));
+            }
+        } else {
+            moves.push_back(Move(fromSquare, toSquare, 0, capture, color, 1, 0));
+        }
+    }
+}
 
-    // Push the move onto the stack for undo functionality
-    moveStack.push(move);
+bool ChessLogic::isPinnedOffLine(short fromSquare, short toSquare, const legalMoveMasks &masks) const {
+    return (masks.pinned & (1ULL << fromSquare)) && !(AttackTables::line(masks.kingSquare, fromSquare) & (1ULL << toSquare));
+}
 
-    // Handle castling
-    if (move.moveType == 1) { // Kingside castling
-        internalBoard[move.to] = internalBoard[move.from]; // Move king
-        internalBoard[move.from] = {0, 0}; // Clear king's original square
-        internalBoard[move.to - 1] = internalBoard[move.to + 1]; // Move rook
-        internalBoard[move.to + 1] = {0, 0}; // Clear rook's original square
-        return;
-    } else if (move.moveType == 2) { // Queenside castling
-        internalBoard[move.to] = internalBoard[move.from]; // Move king
-        internalBoard[move.from] = {0, 0}; // Clear king's original square
-        internalBoard[move.to + 1] = internalBoard[move.to - 2]; // Move rook
-        internalBoard[move.to - 2] = {0, 0}; // Clear rook's original square
-        return;
+template<short color>
+bool ChessLogic::isEnPassantLegal(short fromSquare, const legalMoveMasks &masks) const {
+    constexpr short opponentColor = (color == WHITE) ? BLACK : WHITE;
+    if (masks.kingSquare == -1) {
+        return true;
     }
+    short capturedPawnSquare = (color == WHITE) ? enPassantSquare + 8 : enPassantSquare - 8;
+    uint64_t capturedBit = 1ULL << capturedPawnSquare;
 
-    // Handle en passant
-    if (move.moveType == 3) { // En passant
-        internalBoard[move.to] = internalBoard[move.from]; // Move pawn
-        internalBoard[move.from] = {0, 0}; // Clear pawn's original square
-        short capturedPawnSquare = (move.color == 1) ? move.to + 8 : move.to - 8;
-        internalBoard[capturedPawnSquare] = {0, 0}; // Clear the captured pawn
+    // both pawns leave the capturing rank, so test the resulting occupancy directly instead of the pin masks
+    uint64_t occupiedAfter = (getOccupiedBitBoard() ^ (1ULL << fromSquare) ^ capturedBit) | (1ULL << enPassantSquare);
+    uint64_t queens = pieceBitBoards[opponentColor][5];
+    uint64_t diagonalSliders = pieceBitBoards[opponentColor][3] | queens;
+    uint64_t straightSliders = pieceBitBoards[opponentColor][4] | queens;
+
+    if (sliders->bishopAttacks(masks.kingSquare, occupiedAfter) & diagonalSliders) {
+        return false;
+    }
+    if (sliders->rookAttacks(masks.kingSquare, occupiedAfter) & straightSliders) {
+        return false;
+    }
+    // a knight or pawn check is only answered if the captured pawn was the checker
+    return !(masks.checkers & ~capturedBit & ~diagonalSliders & ~straightSliders);
+}
+
+template<short color>
+void ChessLogic::generateCastlingMoves(const legalMoveMasks &masks, MoveList &moves) const {
+    bool kingside = (color == WHITE) ? whiteKCastle : blackKCastle;
+    bool queenside = (color == WHITE) ? whiteQCastle : blackQCastle;
+    constexpr short kingSquare = (color == WHITE) ? 60 : 4;
+
+    if ((!kingside && !queenside) || masks.kingSquare != kingSquare) {
         return;
     }
 
-    // Update the internal board for normal moves
-    internalBoard[move.to] = internalBoard[move.from]; // Move the piece
-    if (move.promotion != 0) {
-        internalBoard[move.to].type = move.promotion; // Promote the pawn
+    uint64_t occupied = getOccupiedBitBoard();
+    uint64_t rooks = pieceBitBoards[color][4];
+
+    // squares between king and rook must be empty, the king may not pass through or land on an attacked square
+    constexpr uint64_t kingsidePath = (1ULL << (kingSquare + 1)) | (1ULL << (kingSquare + 2));
+    constexpr uint64_t queensidePath = (1ULL << (kingSquare - 1)) | (1ULL << (kingSquare - 2)) | (1ULL << (kingSquare - 3));
+    constexpr uint64_t queensideKingPath = (1ULL << (kingSquare - 1)) | (1ULL << (kingSquare - 2));
+
+    if (kingside && !(occupied & kingsidePath) && !(masks.attacked & kingsidePath) && (rooks & (1ULL << (kingSquare + 3)))) {
+        moves.push_back(Move(kingSquare, kingSquare + 2, 0, 0, color, 6, 1));
+    }
+    if (queenside && !(occupied & queensidePath) && !(masks.attacked & queensideKingPath) && (rooks & (1ULL << (kingSquare - 4)))) {
+        moves.push_back(Move(kingSquare, kingSquare - 2, 0, 0, color, 6, 2));
+    }
+}
+
+bool ChessLogic::isLegalInPosition(const Move &move, const legalMoveMasks &masks) const {
+    short color = move.color();
+    short fromSquare = move.from();
+    short toSquare = move.to();
+    uint64_t toBit = 1ULL << toSquare;
+
+    if (move.isNull() || internalBoard[fromSquare].color != color || internalBoard[fromSquare].type != move.piece()) {
+        return false; // the piece is not on its starting square
     }
-    internalBoard[move.from] = {0, 0}; // Clear the starting square
 
-    castleStack.push(castleRights(whiteKCastle, whiteQCastle, blackKCastle, blackQCastle)); // record the previous castling rights
-    // Update castling rights
-    if (move.from == 60) { // White king moves
+    bool doubleCheck = masks.checkers & (masks.checkers - 1);
+
+    if (move.moveType() == 1 || move.moveType() == 2) { // Castling
+        MoveList castlingMoves;
+        if (!masks.checkers) {
+            if (color == WHITE) {
+                generateCastlingMoves<WHITE>(masks, castlingMoves);
+            } else {
+                generateCastlingMoves<BLACK>(masks, castlingMoves);
+            }
+        }
+        for (const Move &castlingMove : castlingMoves) {
+            if (castlingMove == move) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (move.moveType() == 3) { // En passant
+        return toSquare == enPassantSquare && !doubleCheck && (AttackTables::pawnAttacks(fromSquare, color) & toBit)
+            && (color == WHITE ? isEnPassantLegal<WHITE>(fromSquare, masks) : isEnPassantLegal<BLACK>(fromSquare, masks));
+    }
+
+    // the target has to hold the piece the move captured, never an own piece
+    const chessPiece &target = internalBoard[toSquare];
+    if (target.type != move.capture() || (target.type != 0 && target.color == color)) {
+        return false;
+    }
+
+    if (move.piece() == 6) {
+        return move.moveType() == 0 && (AttackTables::kingAttacks(fromSquare) & toBit) && !(masks.attacked & toBit);
+    }
+
+    if (doubleCheck || !(masks.evasionMask & toBit) || isPinnedOffLine(fromSquare, toSquare, masks)) {
+        return false;
+    }
+
+    uint64_t occupied = getOccupiedBitBoard();
+    if (move.piece() == 1) {
+        short forward = (color == 1) ? -8 : 8;
+        uint64_t promotionRank = (color == 1) ? 0x00000000000000FFULL : 0xFF00000000000000ULL;
+        if (((toBit & promotionRank) != 0) != (move.promotion() != 0)) {
+            return false; // a pawn reaching the last rank has to promote
+        }
+        if (move.capture()) {
+            return move.moveType() == 0 && (AttackTables::pawnAttacks(fromSquare, color) & toBit);
+        }
+        if (move.moveType() == 4) {
+            return toSquare == fromSquare + 2 * forward && fromSquare / 8 == (color == 1 ? 6 : 1)
+                && !(occupied & (1ULL << (fromSquare + forward)));
+        }
+        return move.moveType() == 0 && toSquare == fromSquare + forward;
+    }
+
+    if (move.moveType() != 0 || move.promotion() != 0) {
+        return false;
+    }
+    switch (move.piece()) {
+        case 2: return AttackTables::knightAttacks(fromSquare) & toBit;
+        case 3: return sliders->bishopAttacks(fromSquare, occupied) & toBit;
+        case 4: return sliders->rookAttacks(fromSquare, occupied) & toBit;
+        case 5: return sliders->queenAttacks(fromSquare, occupied) & toBit;
+    }
+    return false;
+}
+
+ChessLogic::stateRecord &ChessLogic::pushHistory(const Move &move) {
+    if (historyCount == MAX_HISTORY) {
+        // drop the older half, search never unwinds that far back into the game
+        std::memmove(history, history + MAX_HISTORY / 2, sizeof(stateRecord) * (MAX_HISTORY / 2));
+        historyCount = MAX_HISTORY / 2;
+    }
+    stateRecord &record = history[historyCount++];
+    record.move = move;
+    record.enPassantSquare = enPassantSquare;
+    record.halfMoveClock = halfMoveClock;
+    record.positionKey = positionKey;
+    return record;
+}
+
+void ChessLogic::makeMove(const Move &move) {
+
+    // Record what the move overwrites for undo functionality
+    stateRecord &record = pushHistory(move);
+    record.capturedPiece = (move.moveType() == 3) ? 1 : internalBoard[move.to()].type;
+    record.rights = castleRights(whiteKCastle, whiteQCastle, blackKCastle, blackQCastle);
+
+    // the board edits below update the piece keys, castling and en passant are swapped in at the end
+    positionKey ^= castlingAndEnPassantKey();
+
+    if (move.moveType() == 1) { // Kingside castling
+        movePiece(move.from(), move.to()); // Move king
+        movePiece(move.to() + 1, move.to() - 1); // Move rook
+    } else if (move.moveType() == 2) { // Queenside castling
+        movePiece(move.from(), move.to()); // Move king
+        movePiece(move.to() - 2, move.to() + 1); // Move rook
+    } else if (move.moveType() == 3) { // En passant
+        movePiece(move.from(), move.to()); // Move pawn
+        short capturedPawnSquare = (move.color() == 1) ? move.to() + 8 : move.to() - 8;
+        removePiece(capturedPawnSquare); // Clear the captured pawn
+    } else {
+        // Update the internal board for normal moves
+        if (internalBoard[move.to()].type != 0) {
+            removePiece(move.to()); // Remove the captured piece
+        }
+        if (move.promotion() != 0) {
+            removePiece(move.from());
+            putPiece(move.to(), chessPiece(move.color(), move.promotion())); // Promote the pawn
+        } else {
+            movePiece(move.from(), move.to()); // Move the piece
+        }
+    }
+
+    // Update castling rights, a king or rook leaving its square or a rook being captured on it
+    revokeCastleRights(move.from());
+    revokeCastleRights(move.to());
+
+    // Update en passant square
+    if (move.moveType() == 4) { // Pawn double move
+        enPassantSquare = (move.from() + move.to()) / 2; // Set en passant square
+    } else {
+        enPassantSquare = -1; // Reset en passant square
+    }
+
+    // Captures and pawn moves reset the fifty move counter
+    if (move.piece() == 1 || record.capturedPiece != 0) {
+        halfMoveClock = 0;
+    } else {
+        halfMoveClock++;
+    }
+
+    whiteToMove = !whiteToMove;
+    positionKey ^= castlingAndEnPassantKey() ^ ZOBRIST.turn;
+}
+
+uint64_t ChessLogic::castlingAndEnPassantKey() const {
+    uint64_t key = 0;
+    if (whiteKCastle) key ^= ZOBRIST.castling[0];
+    if (whiteQCastle) key ^= ZOBRIST.castling[1];
+    if (blackKCastle) key ^= ZOBRIST.castling[2];
+    if (blackQCastle) key ^= ZOBRIST.castling[3];
+    if (enPassantSquare != -1) {
+        key ^= ZOBRIST.enPassant[enPassantSquare % 8];
+    }
+    return key;
+}
+
+void ChessLogic::revokeCastleRights(short square) {
+    if (square == 60) { // White king square
         whiteQCastle = false;
         whiteKCastle = false;
-    } else if (move.from == 56) { // White queenside rook moves
+    } else if (square == 56) { // White queenside rook square
         whiteQCastle = false;
-    } else if (move.from == 63) { // White kingside rook moves
+    } else if (square == 63) { // White kingside rook square
         whiteKCastle = false;
-    } else if (move.from == 4) { // Black king moves
+    } else if (square == 4) { // Black king square
         blackQCastle = false;
         blackKCastle = false;
-    } else if (move.from == 0) { // Black queenside rook moves
+    } else if (square == 0) { // Black queenside rook square
         blackQCastle = false;
-    } else if (move.from == 7) { // Black kingside rook moves
+    } else if (square == 7) { // Black kingside rook square
         blackKCastle = false;
     }
-
-    // Update en passant square
-    if (move.moveType == 4) { // Pawn double move
-        enPassantSquare = (move.from + move.to) / 2; // Set en passant square
-    } else {
-        enPassantSquare = -1; // Reset en passant square
-    }
-
 }
 
 bool ChessLogic::isMoveLegal(const Move &move) {
-    bool isLegal = true;
-    // Temporarily make the move
-    makeMove(move);
-
-    if (isInCheck(move.color == 1)) {
-        isLegal = false; // Move leaves the king in check
+    if (move.color() != 1 && move.color() != 2) {
+        return false; // No piece on the starting square
     }
 
-    undoMove(); // Undo the move
-
-    // Additional checks for castling
-    if (isLegal && move.piece == 6 && (move.moveType == 1 || move.moveType == 2)) { // King castling
-        short step = (move.moveType == 1) ? 1 : -1; // Kingside or Queenside
-        short kingSquare = move.from;
-
-        // Check if the king passes through or lands on a square under attack
-        for (short i = 0; i <= 2; ++i) { // Check up to 2 squares (including the destination)
-            if (isInCheck(move.color == 1)) {
-                isLegal = false; // King passes through or lands on a square under attack
-                break;
-            }
-            kingSquare += step; // Move the king to the next square
-
-            ChessLogic::Move stepMove = Move();
-            stepMove.from = move.from;
-            stepMove.to = kingSquare;
-            stepMove.piece = move.piece;
-            stepMove.color = move.color;
-            makeMove(stepMove); // Temporarily move the king
-        }
+    MoveList legalMoves;
+    generateLegalMoves(move.color(), legalMoves);
 
-        // Undo the temporary moves
-        for (short i = 0; i <= 2; ++i) {
-            undoMove();
+    for (const auto &legalMove : legalMoves) {
+        if (legalMove.from() == move.from() && legalMove.to() == move.to() && legalMove.promotion() == move.promotion()) {
+            return true;
         }
     }
-
-    return isLegal;
+    return false;
 }
 
 void ChessLogic::undoMove() {
-    if (moveStack.empty()) {
+    if (historyCount == 0) {
+        return;
+    }
+    if (history[historyCount - 1].move.isNull()) {
+        undoNullMove();
         return;
     }
 
-    // Pop the last move from the stack
-    Move lastMove = moveStack.top();
-    moveStack.pop();
+    // Pop the last record from the history
+    const stateRecord &record = history[--historyCount];
+    const Move &lastMove = record.move;
 
-    // Undo the move on the internal board
-    internalBoard[lastMove.from] = chessPiece(lastMove.color, lastMove.piece);
-    internalBoard[lastMove.to] = {0, 0}; // Clear the destination square
+    // Undo the move on the internal board, a promoted piece goes back as the original pawn
+    removePiece(lastMove.to()); // Clear the destination square
+    putPiece(lastMove.from(), chessPiece(lastMove.color(), lastMove.piece()));
 
     // Handle captures
-    if (lastMove.capture) {
-        internalBoard[lastMove.to] = chessPiece(lastMove.color == 1 ? 2 : 1, lastMove.capture);
+    if (record.capturedPiece && lastMove.moveType() != 3) {
+        putPiece(lastMove.to(), chessPiece(lastMove.color() == 1 ? 2 : 1, record.capturedPiece));
     }
 
     // Handle castling
-    if (lastMove.moveType == 1) { // Kingside castling
-        internalBoard[lastMove.to + 1] = chessPiece(internalBoard[lastMove.to - 1].color, 4); // Move rook back
-        internalBoard[lastMove.to - 1] = {0, 0}; // Clear rook's new square
-    } else if (lastMove.moveType == 2) { // Queenside castling
-        internalBoard[lastMove.to - 2] = chessPiece(internalBoard[lastMove.to + 1].color, 4); // Move rook back
-        internalBoard[lastMove.to + 1] = {0, 0}; // Clear rook's new square
+    if (lastMove.moveType() == 1) { // Kingside castling
+        movePiece(lastMove.to() - 1, lastMove.to() + 1); // Move rook back
+    } else if (lastMove.moveType() == 2) { // Queenside castling
+        movePiece(lastMove.to() + 1, lastMove.to() - 2); // Move rook back
     }
 
     // Handle en passant
-    if (lastMove.moveType == 3) { // En passant
-        short capturedPawnSquare = (lastMove.color == 1) ? lastMove.to + 8 : lastMove.to - 8;
-        internalBoard[capturedPawnSquare] = chessPiece(lastMove.color == 1 ? 2 :1, 1);
-        internalBoard[lastMove.to] = {0, 0}; // Clear the en passant capture square
-    }
+    if (lastMove.moveType() == 3) { // En passant
+        short capturedPawnSquare = (lastMove.color() == 1) ? lastMove.to() + 8 : lastMove.to() - 8;
+        putPiece(capturedPawnSquare, chessPiece(lastMove.color() == 1 ? 2 : 1, 1));
+    }
+
+    // Restore the irreversible state, the board edits above changed the key so it is restored last
+    whiteKCastle = record.rights.wKingside;
+    whiteQCastle = record.rights.wQueenside;
+    blackKCastle = record.rights.bKingside;
+    blackQCastle = record.rights.bQueenside;
+    enPassantSquare = record.enPassantSquare;
+    halfMoveClock = record.halfMoveClock;
+    positionKey = record.positionKey;
+    whiteToMove = !whiteToMove;
+}
 
-    // Handle pawn promotion
-    if (lastMove.piece == 1 && lastMove.promotion != 0) { // If the move was a pawn promotion
-        internalBoard[lastMove.from].type = 1; // Restore the piece type to pawn
-    }
+void ChessLogic::makeNullMove() {
+    stateRecord &record = pushHistory(Move());
+    record.capturedPiece = 0;
+
+    // castling rights cannot change without a move, record.rights is left as it is
 
-    // Restore castling rights
-    if (!castleStack.empty()) {
-        castleRights oldRights = castleStack.top();
-        castleStack.pop();
-        whiteKCastle = oldRights.wKingside;
-        whiteQCastle = oldRights.wQueenside;
-        blackKCastle = oldRights.bKingside;
-        blackQCastle = oldRights.bQueenside;
+    if (enPassantSquare != -1) {
+        positionKey ^= ZOBRIST.enPassant[enPassantSquare % 8];
+        enPassantSquare = -1;
     }
+    halfMoveClock++;
+    whiteToMove = !whiteToMove;
+    positionKey ^= ZOBRIST.turn;
+}
 
-    // Restore en passant square
-    if (!moveStack.empty()) {
-        const Move &previousMove = moveStack.top();
-        enPassantSquare = (previousMove.moveType == 4) ? (previousMove.from + previousMove.to) / 2 : -1;
-    } else {
-        enPassantSquare = -1; // Reset if no previous move
+bool ChessLogic::undoNullMove() {
+    if (historyCount == 0 || !history[historyCount - 1].move.isNull()) {
+        return false;
     }
+
+    const stateRecord &record = history[--historyCount];
+    enPassantSquare = record.enPassantSquare;
+    halfMoveClock = record.halfMoveClock;
+    positionKey = record.positionKey;
+    whiteToMove = !whiteToMove;
+    return true;
 }
 
 void ChessLogic::emtpyMoveStack() {
-    while (!moveStack.empty()) {
-        moveStack.pop();
-    }
-    while (!castleStack.empty())
-    {
-        castleStack.pop();
-    }
+    historyCount = 0;
 }
 
 ChessLogic::Move ChessLogic::translateMove(short fromSquare, short toSquare) const {
-    Move move;
-    move.from = fromSquare;
-    move.to = toSquare;
-    move.piece = internalBoard[fromSquare].type;
-    move.color = internalBoard[fromSquare].color;
+    short piece = internalBoard[fromSquare].type;
+    short color = internalBoard[fromSquare].color;
 
     // Check for captures
-    if (internalBoard[toSquare].type != 0) {
-        move.capture = internalBoard[toSquare].type;
-    } else {
-        move.capture = 0;
-    }
+    short capture = internalBoard[toSquare].type;
 
     // Determine move type (e.g., castling, en passant, pawn double move)
-    move.moveType = 0; // Default to normal move
-    if (move.piece == 6 && abs(fromSquare - toSquare) == 2) { // King castling
-        move.moveType = (toSquare > fromSquare) ? 1 : 2; // Kingside or Queenside
-    } else if (move.piece == 1 && abs(fromSquare - toSquare) == 16) { // Pawn double move
-        move.moveType = 4;
-    } else if (move.piece == 1 && internalBoard[toSquare].type == 0 && abs(fromSquare - toSquare) % 8 != 0) { // En passant
-        move.moveType = 3;
-        move.capture = 1; // Pawn captured
-    }
-    return Move(move);
+    short moveType = 0; // Default to normal move
+    if (piece == 6 && abs(fromSquare - toSquare) == 2) { // King castling
+        moveType = (toSquare > fromSquare) ? 1 : 2; // Kingside or Queenside
+    } else if (piece == 1 && abs(fromSquare - toSquare) == 16) { // Pawn double move
+        moveType = 4;
+    } else if (piece == 1 && internalBoard[toSquare].type == 0 && abs(fromSquare - toSquare) % 8 != 0) { // En passant
+        moveType = 3;
+        capture = 1; // Pawn captured
+    }
+    return Move(fromSquare, toSquare, 0, capture, color, piece, moveType);
 }
 
 ChessLogic::Move ChessLogic::translateMove(const std::string &moveStr) const {
@@ -530,15 +1145,15 @@ ChessLogic::Move ChessLogic::translateMove(const std::string &moveStr) const {
     // Handle promotion
     if (moveStr.length() == 5) {
         switch (moveStr[4]) {
-            case 'n': move.promotion = 2; break; // Knight
-            case 'b': move.promotion = 3; break; // Bishop
-            case 'r': move.promotion = 4; break; // Rook
-            case 'q': move.promotion = 5; break; // Queen
+            case 'n': move.setPromotion(2); break; // Knight
+            case 'b': move.setPromotion(3); break; // Bishop
+            case 'r': move.setPromotion(4); break; // Rook
+            case 'q': move.setPromotion(5); break; // Queen
             std::cerr << "Invalid promotion piece" << std::endl;
             std::abort();
         }
     } else {
-        move.promotion = 0; // No promotion
+        move.setPromotion(0); // No promotion
     }
 
     return move;
@@ -547,18 +1162,18 @@ ChessLogic::Move ChessLogic::translateMove(const std::string &moveStr) const {
 std::string ChessLogic::translateMoveToString(const Move &move) const {
 
     // Check for a null move
-    if (move.from == -1 && move.to == -1) {
+    if (move.isNull()) {
         return "0000"; // Null move representation
     }
 
     std::string moveStr;
 
-    moveStr += squareToString(move.from); // Convert the 'from' square to algebraic notation
-    moveStr += squareToString(move.to);   // Convert the 'to' square to algebraic notation
+    moveStr += squareToString(move.from()); // Convert the 'from' square to algebraic notation
+    moveStr += squareToString(move.to());   // Convert the 'to' square to algebraic notation
 
     // Add promotion piece if applicable
-    if (move.promotion != 0) {
-        switch (move.promotion) {
+    if (move.promotion() != 0) {
+        switch (move.promotion()) {
             case 2: moveStr += 'n'; break; // Knight
             case 3: moveStr += 'b'; break; // Bishop
             case 4: moveStr += 'r'; break; // Rook
@@ -574,89 +1189,17 @@ const ChessLogic::chessPiece* ChessLogic::getChessBoard() const {
 }
 
 bool ChessLogic::isInCheck(bool isWhite) const {
+    return isWhite ? isInCheck<WHITE>() : isInCheck<BLACK>();
+}
 
-    short color = isWhite ? 1 : 2;
-
-    // Find the king's position
-    short kingSquare = -1;
-    for (short i = 0; i < 64; ++i) {
-        if (internalBoard[i].type == 6 && internalBoard[i].color == color) {
-            
-            kingSquare = i;
-            break;
-        }
-    }
-
+template<short color>
+bool ChessLogic::isInCheck() const {
+    constexpr short opponentColor = (color == WHITE) ? BLACK : WHITE;
+    short kingSquare = kingSquares[color];
     if (kingSquare == -1) {
         return false; // No king found, technically not in check
     }
-
-    short opponentColor = (color == 1) ? 2 : 1;
-
-    // Check for attacks from pawns
-    short pawnDirection = (color == 1) ? -8 : 8;
-    if (getSqureXYrelative(kingSquare, -1, pawnDirection / 8) != -1 &&
-        internalBoard[getSqureXYrelative(kingSquare, -1, pawnDirection / 8)].type == 1 &&
-        internalBoard[getSqureXYrelative(kingSquare, -1, pawnDirection / 8)].color == opponentColor) {
-        return true;
-    }
-    if (getSqureXYrelative(kingSquare, 1, pawnDirection / 8) != -1 &&
-        internalBoard[getSqureXYrelative(kingSquare, 1, pawnDirection / 8)].type == 1 &&
-        internalBoard[getSqureXYrelative(kingSquare, 1, pawnDirection / 8)].color == opponentColor) {
-        return true;
-    }
-
-    // Check for attacks from knights
-    const short knightMoves[8][2] = {{-2, -1}, {-2, 1}, {2, -1}, {2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}};
-    for (const auto &move : knightMoves) {
-        short targetSquare = getSqureXYrelative(kingSquare, move[0], move[1]);
-        if (targetSquare != -1 && internalBoard[targetSquare].type == 2 && internalBoard[targetSquare].color == opponentColor) {
-            return true;
-        }
-    }
-
-    // Check for attacks from bishops and queens (diagonal)
-    const short bishopDirections[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
-    for (const auto &dir : bishopDirections) {
-        short targetSquare = kingSquare;
-        while ((targetSquare = getSqureXYrelative(targetSquare, dir[0], dir[1])) != -1) {
-            if (internalBoard[targetSquare].type != 0) {
-                if ((internalBoard[targetSquare].type == 3 || internalBoard[targetSquare].type == 5) &&
-                    internalBoard[targetSquare].color == opponentColor) {
-                    return true;
-                }
-                break;
-            }
-        }
-    }
-
-    // Check for attacks from rooks and queens (straight lines)
-    const short rookDirections[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-    for (const auto &dir : rookDirections) {
-        short targetSquare = kingSquare;
-        targetSquare = getSqureXYrelative(targetSquare, dir[0], dir[1]);
-        while (targetSquare != -1) {
-            if (internalBoard[targetSquare].type != 0) {
-                if ((internalBoard[targetSquare].type == 4 || internalBoard[targetSquare].type == 5) &&
-                    internalBoard[targetSquare].color == opponentColor) {
-                    return true;
-                }
-                break;
-            }
-            targetSquare = getSqureXYrelative(targetSquare, dir[0], dir[1]);
-        }
-    }
-
-    // Check for attacks from the opponent king
-    const short kingMoves[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
-    for (const auto &move : kingMoves) {
-        short targetSquare = getSqureXYrelative(kingSquare, move[0], move[1]);
-        if (targetSquare != -1 && internalBoard[targetSquare].type == 6 && internalBoard[targetSquare].color == opponentColor) {
-            return true;
-        }
-    }
-
-    return false; // No attacks found, king is not in check
+    return isSquareAttacked(kingSquare, opponentColor, getOccupiedBitBoard());
 }
 
 std::vector<short> ChessLogic::bitboardToSquares(uint64_t bitboard) const {
@@ -670,30 +1213,23 @@ std::vector<short> ChessLogic::bitboardToSquares(uint64_t bitboard) const {
 }
 
 uint64_t ChessLogic::getPawnMoveBitBoard(short color) const {
+    return (color == WHITE) ? getPawnMoveBitBoard<WHITE>() : getPawnMoveBitBoard<BLACK>();
+}
+
+template<short color>
+uint64_t ChessLogic::getPawnMoveBitBoard() const {
     uint64_t pawnBitboard = getPieceBitBoard(color, 1); // Get bitboard for pawns
     uint64_t emptySquares = ~getColorBitBoard(1) & ~getColorBitBoard(2); // Empty squares
-    uint64_t opponentBitboard = getColorBitBoard(color == 1 ? 2 : 1); // Opponent pieces
 
-    uint64_t singlePush = 0;
-    uint64_t doublePush = 0;
-    uint64_t capturesLeft = 0;
-    uint64_t capturesRight = 0;
+    // the rank a pawn reaches with its first push, from there it can push once more
+    constexpr uint64_t firstPushRank = (color == WHITE) ? 0x0000FF0000000000ULL : 0x0000000000FF0000ULL;
 
-    if (color == 1) { // White pawns
-        singlePush = (pawnBitboard >> 8) & emptySquares; // Move one square forward
-        doublePush = ((singlePush & 0x0000FF0000000000) >> 8) & emptySquares; // Move two squares forward from rank 2
-        capturesLeft = (pawnBitboard >> 9) & ~0x0101010101010101; // Diagonal left capture
-        capturesRight = (pawnBitboard >> 7) & ~0x8080808080808080; // Diagonal right capture
-        
-    } else { // Black pawns
-        singlePush = (pawnBitboard << 8) & emptySquares; // Move one square forward
-        doublePush = ((singlePush & 0x0000000000FF0000) << 8) & emptySquares; // Move two squares forward from rank 7
-        capturesLeft = (pawnBitboard << 7) & ~0x0101010101010101; // Diagonal left capture
-        capturesRight = (pawnBitboard << 9) & ~0x8080808080808080; // Diagonal right capture
-    }
+    uint64_t singlePush = shiftForward<color>(pawnBitboard) & emptySquares; // Move one square forward
+    uint64_t doublePush = shiftForward<color>(singlePush & firstPushRank) & emptySquares; // Move two squares forward
+    uint64_t captures = AttackTables::allPawnAttacks(pawnBitboard, color); // Diagonal captures
 
     // Combine all possible moves
-    return singlePush | doublePush | capturesLeft | capturesRight;
+    return singlePush | doublePush | captures;
 }
 
 uint64_t ChessLogic::getKnightMoveBitBoard(short color) const {
@@ -702,30 +1238,8 @@ uint64_t ChessLogic::getKnightMoveBitBoard(short color) const {
     uint64_t opponentBitboard = getColorBitBoard(color == 1 ? 2 : 1); // Opponent pieces
 
     uint64_t knightMoves = 0;
-    const short knightOffsets[8] = {-17, -15, -10, -6, 6, 10, 15, 17};
-
-    for (short i = 63; i >= 0; i--) {
-
-        if (knightBitboard & (1ULL << i)) {
-
-            for (short j = 0; j < 8; ++j) {
-                short targetSquare = i + knightOffsets[j];
-                if (targetSquare >= 0 && targetSquare < 64) {
-                    if ((knightOffsets[j] == -10 && (i % 8 <= 1)) // queenside check
-                        || (knightOffsets[j] == 6 && (i % 8 <= 1))
-                        || (knightOffsets[j] == -17 && (i % 8 == 0))
-                        || (knightOffsets[j] == 15 && (i % 8 == 0))
-                        || (knightOffsets[j] == -6 && (i % 8 >= 6)) // kingside check
-                        || (knightOffsets[j] == 10 && (i % 8 >= 6)) 
-                        || (knightOffsets[j] == 17 && (i % 8 == 7)) 
-                        || (knightOffsets[j] == -15 && (i % 8 == 7))) {
-                            continue; // Skip invalid moves
-                    }
-                    knightMoves |= (1ULL << targetSquare);
-                }
-            }
-            
-        }
+    while (knightBitboard) {
+        knightMoves |= AttackTables::knightAttacks(popLeastSignificantBit(knightBitboard));
     }
 
     return knightMoves | opponentBitboard;
@@ -736,39 +1250,9 @@ uint64_t ChessLogic::getBishopMoveBitBoard(short color) const {
     uint64_t opponentBitboard = getColorBitBoard(color == 1 ? 2 : 1); // Opponent pieces
 
     uint64_t bishopMoves = 0;
-    const short bishopOffsets[4] = {-9, -7, 7, 9}; // Diagonal moves};
-
-    for (short i = 63; i >= 0; i--) {
-        if (bishopBitboard & (1ULL << i)) { // if bishop is on the square
-            for (short j = 0; j < 4; ++j) {
-                short targetSquare = i + bishopOffsets[j];
-                while (targetSquare >= 0 && targetSquare < 64) {
-                    if ((bishopOffsets[j] == -9 && (i % 8 == 0))
-                        || (bishopOffsets[j] == -7 && (i % 8 == 7))
-                        || (bishopOffsets[j] == 7 && (i % 8 == 0))
-                        || (bishopOffsets[j] == 9 && (i % 8 == 7))
-                    ) {
-                        
-                        break; // Skip invalid moves
-                    }
-                    bishopMoves |= (1ULL << targetSquare);
-                    if ((bishopOffsets[j] == -9 && (targetSquare % 8 == 0))
-                        || (bishopOffsets[j] == -7 && (targetSquare % 8 == 7))
-                        || (bishopOffsets[j] == 7 && (targetSquare % 8 == 0))
-                        || (bishopOffsets[j] == 9 && (targetSquare % 8 == 7))
-                    ) {
-                        // reached a corner
-                        
-                        break; // Skip invalid moves
-                    }
-                    targetSquare = targetSquare + bishopOffsets[j];
-                    if (internalBoard[targetSquare].type != 0) {
-                        break; // Stop at the first piece encountered
-                    }
-                    
-                }
-            }
-        }
+    while (bishopBitboard) {
+        short square = popLeastSignificantBit(bishopBitboard);
+        bishopMoves |= sliders->bishopAttacks(square, ~emptySquares); // magic lookup stops at the first blocker
     }
 
     return (bishopMoves & emptySquares) | opponentBitboard;
@@ -779,29 +1263,9 @@ uint64_t ChessLogic::getRookMoveBitBoard(short color) const {
     uint64_t opponentBitboard = getColorBitBoard(color == 1 ? 2 : 1); // Opponent pieces
 
     uint64_t rookMoves = 0;
-    const short rookOffsets[4] = {-8, 8, -1, 1}; // Straight line moves
-
-    for (short i = 0; i < 64; ++i) {
-        if (rookBitboard & (1ULL << i)) {
-            for (short j = 0; j < 4; ++j) {
-                short targetSquare = i + rookOffsets[j];
-                while (targetSquare >= 0 && targetSquare < 64) {
-                    if ((rookOffsets[j] == -1 && (i % 8 == 0))
-                        || (rookOffsets[j] == 1 && (i % 8 == 7))) {
-                        break; // Skip invalid moves
-                    }
-                    rookMoves |= (1ULL << targetSquare);
-                    if ((rookOffsets[j] == -1 && (targetSquare % 8 == 0))
-                        || (rookOffsets[j] == 1 && (targetSquare % 8 == 7))) {
-                        break; // Skip invalid moves
-                    }
-                    targetSquare = targetSquare + rookOffsets[j];
-                    if (internalBoard[targetSquare].type != 0) {
-                        break; // Stop at the first piece encountered
-                    }
-                }
-            }
-        }
+    while (rookBitboard) {
+        short square = popLeastSignificantBit(rookBitboard);
+        rookMoves |= sliders->rookAttacks(square, ~emptySquares); // magic lookup stops at the first blocker
     }
 
     return (rookMoves & emptySquares) | opponentBitboard;
@@ -824,93 +1288,129 @@ uint64_t ChessLogic::getKingMoveBitBoard(short color) const {
     uint64_t opponentBitboard = getColorBitBoard(color == 1 ? 2 : 1); // Opponent pieces
 
     uint64_t kingMoves = 0;
-    const short kingOffsets[8][2] = {{-1, -8}, {0, -8}, {1, -8}, {-1, 0}, {1, 0}, {-1, 8}, {0, 8}, {1, 8}};
-
-    for (short i = 63; i >= 0; i--) {
-        if (kingBitboard & (1ULL << i)) {
-            for (short j = 0; j < 8; ++j) {
-                short targetSquare = i + kingOffsets[j][0] + kingOffsets[j][1];
-                if (targetSquare >= 0 && targetSquare < 64) {
-                    if ((kingOffsets[j][0] == -1 && (i % 8 == 0)) || 
-                        (kingOffsets[j][0] == 1 && (i % 8 == 7))) {
-                        continue; // Skip invalid moves
-                    }
-                    kingMoves |= (1ULL << targetSquare);
-                }
-            }
-        }
+    while (kingBitboard) {
+        kingMoves |= AttackTables::kingAttacks(popLeastSignificantBit(kingBitboard));
     }
 
     return (kingMoves & emptySquares) | opponentBitboard;
 }
 
-void ChessLogic::initializeZobrist() {
-    std::mt19937_64 rng(123456); // Random number generator with a fixed seed
-    std::uniform_int_distribution<uint64_t> dist;
+uint64_t ChessLogic::hashPosition(bool isWhiteTurn) const {
+    uint64_t hash = 0;
 
-    // Initialize Zobrist table for pieces on squares
+    // Hash the pieces on the board
     for (int square = 0; square < 64; ++square) {
-        for (int piece = 0; piece < 12; ++piece) { // 6 piece types * 2 colors
-            zobristTable[square][piece] = dist(rng);
+        const chessPiece &piece = internalBoard[square];
+        if (piece.type != 0) { // If the square is not empty
+            hash ^= ZOBRIST.pieces[piece.color][piece.type][square];
         }
     }
 
-    // Initialize Zobrist values for castling rights
-    for (int i = 0; i < 4; ++i) {
-        zobristCastling[i] = dist(rng);
+    // Hash castling rights and the en passant file
+    hash ^= castlingAndEnPassantKey();
+
+    // Hash the player's turn
+    if (isWhiteTurn) {
+        hash ^= ZOBRIST.turn;
     }
 
-    // Initialize Zobrist values for en passant files
-    for (int i = 0; i < 8; ++i) {
-        zobristEnPassant[i] = dist(rng);
+    return hash;
+}
+
+uint64_t ChessLogic::getPositionKey() const {
+    return positionKey;
+}
+
+void ChessLogic::setSideToMove(bool isWhite) {
+    whiteToMove = isWhite;
+    positionKey = hashPosition(isWhite);
+}
+
+std::vector<ChessLogic::Move> ChessLogic::getMoveHistory() const {
+    std::vector<Move> moveHistory;
+    for (int i = 0; i < historyCount; ++i) {
+        moveHistory.push_back(history[i].move);
     }
+    return moveHistory;
+}
 
-    // Initialize Zobrist value for the player's turn
-    zobristTurn = dist(rng);
+uint64_t ChessLogic::perft(short depth) {
+    return whiteToMove ? perft<WHITE>(depth) : perft<BLACK>(depth);
 }
 
-uint64_t ChessLogic::hashPosition(bool isWhiteTurn) const {
-    uint64_t hash = 0;
+template<short color>
+uint64_t ChessLogic::perft(short depth) {
+    constexpr short opponentColor = (color == WHITE) ? BLACK : WHITE;
+    if (depth <= 0) {
+        return 1;
+    }
 
-    // Hash the pieces on the board
-    for (int square = 0; square < 64; ++square) {
-        const chessPiece &piece = internalBoard[square];
-        if (piece.type != 0) { // If the square is not empty
-            int pieceIndex = (piece.type - 1) + (piece.color - 1) * 6; // Map to 0-11
-            hash ^= zobristTable[square][pieceIndex];
-        }
+    MoveList moves;
+    generateLegalMoves<color>(moves, ALL_MOVES, getLegalMoveMasks<color>());
+    if (depth == 1) {
+        return moves.size(); // every generated move is legal, no need to make them
     }
 
-    // Hash castling rights
-    if (whiteKCastle) hash ^= zobristCastling[0];
-    if (whiteQCastle) hash ^= zobristCastling[1];
-    if (blackKCastle) hash ^= zobristCastling[2];
-    if (blackQCastle) hash ^= zobristCastling[3];
+    uint64_t nodes = 0;
+    for (const Move &move : moves) {
+        makeMove(move);
+        nodes += perft<opponentColor>(depth - 1);
+        undoMove();
+    }
+    return nodes;
+}
 
-    // Hash en passant square
-    if (enPassantSquare != -1) {
-        int file = enPassantSquare % 8; // Get the file of the en passant square
-        hash ^= zobristEnPassant[file];
+uint64_t ChessLogic::perft(short depth, PerftHash &hash) {
+    if (depth <= 1) {
+        return perft(depth);
     }
 
-    // Hash the player's turn
-    if (isWhiteTurn) {
-        hash ^= zobristTurn;
+    uint64_t nodes = 0;
+    if (hash.probe(positionKey, depth, nodes)) {
+        return nodes;
     }
 
-    return hash;
+    MoveList moves;
+    generateLegalMoves(whiteToMove ? 1 : 2, moves);
+    for (const Move &move : moves) {
+        makeMove(move);
+        nodes += perft(depth - 1, hash);
+        undoMove();
+    }
+    hash.store(positionKey, depth, nodes);
+    return nodes;
 }
 
-std::vector<ChessLogic::Move> ChessLogic::getMoveHistory() const {
-    std::vector<Move> moveHistory;
-    std::stack<Move> tempStack = moveStack;
+std::vector<std::pair<ChessLogic::Move, uint64_t>> ChessLogic::divide(short depth) {
+    std::vector<std::pair<Move, uint64_t>> counts;
+    if (depth <= 0) {
+        return counts;
+    }
 
-    while (!tempStack.empty()) {
-        moveHistory.push_back(tempStack.top());
-        tempStack.pop();
+    MoveList moves;
+    generateLegalMoves(whiteToMove ? 1 : 2, moves);
+    for (const Move &move : moves) {
+        makeMove(move);
+        counts.push_back(std::make_pair(move, perft(depth - 1)));
+        undoMove();
     }
-    std::reverse(moveHistory.begin(), moveHistory.end());
-    return moveHistory;
+    return counts;
+}
+
+int ChessLogic::getRepetitionCount() const {
+    int repetitions = 0;
+    int oldest = std::max(historyCount - halfMoveClock, 0);
+
+    // the same position can only come back with the same side to move, so step back two plies at a time
+    for (int i = historyCount - 2; i >= oldest; i -= 2) {
+        if (history[i].move.isNull() || history[i + 1].move.isNull()) {
+            break; // a passed turn is not a real repetition
+        }
+        if (history[i].positionKey == positionKey) {
+            repetitions++;
+        }
+    }
+    return repetitions;
 }
 
 std::string ChessLogic::printBitBoard(uint64_t bitboard) const {
@@ -959,7 +1459,7 @@ std::string ChessLogic::squareToString(short square) const {
     return std::string(1, file) + std::string(1, rank);
 }
 
-std::string ChessLogic::printLegalMoves(std::vector<ChessLogic::Move> moves) const {
+std::string ChessLogic::printLegalMoves(const MoveList &moves) const {
     std::string formattedString = "\nLegal Moves:\n";
     for (const auto &move : moves) {
         formattedString += translateMoveToString(move) + ", ";
@@ -990,7 +1490,7 @@ short ChessLogic::stringToSquare(const std::string &squareStr) const {
 std::string ChessLogic::printMoves(std::vector<Move> moves) const {
     std::string moveString;
     for (Move move : moves) {
-        moveString += move.color == 1 ? "w: " : "b:";
+        moveString += move.color() == 1 ? "w: " : "b:";
         moveString += translateMoveToString(move) + ", ";
     }
     if (moveString.length() > 2) {
@@ -999,3 +1499,11 @@ std::string ChessLogic::printMoves(std::vector<Move> moves) const {
     }
     return moveString;
 }
+
+// The color templates used outside this file
+template ChessLogic::legalMoveMasks ChessLogic::getLegalMoveMasks<ChessLogic::WHITE>() const;
+template ChessLogic::legalMoveMasks ChessLogic::getLegalMoveMasks<ChessLogic::BLACK>() const;
+template void ChessLogic::generateLegalMoves<ChessLogic::WHITE>(MoveList &, short, const legalMoveMasks &) const;
+template void ChessLogic::generateLegalMoves<ChessLogic::BLACK>(MoveList &, short, const legalMoveMasks &) const;
+template bool ChessLogic::isInCheck<ChessLogic::WHITE>() const;
+template bool ChessLogic::isInCheck<ChessLogic::BLACK>() const;
@@ -6,12 +6,20 @@
 #include <stack>
 #include <limits>
 #include <cstdint>
-#include <unordered_map>
 #include <stdexcept>
 #include <iostream>
 #include <functional>
 #include <random>
 #include <bitset>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <new>
+
+#include "chess_position.h"
+#include "zobrist.h"
+#include "perft_hash.h"
+#include "attack_tables.h"
 
 #ifdef DEBUG
 #define DEBUG_PRINT(x) std::cout << "Debug: " << x <<  "\n";
@@ -19,64 +27,90 @@
 #define DEBUG_PRINT(x)
 #endif
 
-class ChessLogic {
+// The board state lives in ChessPosition, ChessLogic adds the undo history and the move generation on top
+class ChessLogic : public ChessPosition {
 public:
 
+    // Represents a move in chess (e.g., "e2e4") packed into 32 bits
+    // bits 0-5 from, 6-11 to, 12-14 promotion, 15-17 capture, 18-19 color, 20-22 piece, 23-25 move type
+    struct Move {
+        uint32_t data = 0; // a default constructed move is the null move
 
-struct castleRights
-{
-    bool wKingside;
-    bool wQueenside;
-    bool bKingside;
-    bool bQueenside;
+        Move() = default;
 
-    castleRights(bool wKingside = false, bool wQueenside = false, bool bKingside = false, bool bQueenside = false) : 
-        wKingside(wKingside), wQueenside(wQueenside), bKingside(bKingside), bQueenside(bQueenside) {}
-};
+        Move(short from, short to, short promotion, short capture, short color, short piece, short moveType) :
+            data(uint32_t(from) | uint32_t(to) << 6 | uint32_t(promotion) << 12 | uint32_t(capture) << 15 |
+                uint32_t(color) << 18 | uint32_t(piece) << 20 | uint32_t(moveType) << 23) {}
 
+        short from() const { return data & 0x3F; } // Starting square (0-63)
+        short to() const { return (data >> 6) & 0x3F; } // Ending square (0-63)
+        short promotion() const { return (data >> 12) & 0x7; } // Promotion piece type (0 for none, 2-5 for knight to queen)
+        short capture() const { return (data >> 15) & 0x7; } // Captured piece type (0 for none, 1-6 for pawn to king)
+        short color() const { return (data >> 18) & 0x3; } // Color of the piece making the move (1 for white, 2 for black)
+        short piece() const { return (data >> 20) & 0x7; } // Piece type (1-6 for pawn to king)
+        short moveType() const { return (data >> 23) & 0x7; } // Type of move (0 for normal, 1 for Kindgside castling, 2 for Queenside castling, 3 for en passant, 4 for pawn double move)
 
+        bool isNull() const { return data == 0; }
 
-struct chessPiece
-{
-    short color; // 1 = white, 2 = black
-    short type; // 1 = pawn, 2 = knight, 3 = bishop, 4 = rook, 5 = queen, 6 = king  
+        void setPromotion(short promotion) { data = (data & ~(0x7u << 12)) | uint32_t(promotion) << 12; }
 
-    // Overload the assignment operator
-    chessPiece& operator=(const chessPiece& other) {
-        if (this != &other) {
-            this->color = other.color;
-            this->type = other.type;
-        }
-        return *this;
-    }
+        bool operator==(const Move &other) const { return data == other.data; }
+        bool operator!=(const Move &other) const { return data != other.data; }
+    };
+
+    // Everything makeMove overwrites, undoMove restores the position from the record alone
+    struct stateRecord {
+        Move move;
+        short capturedPiece; // piece type taken by the move, 0 for none
+        castleRights rights;
+        int enPassantSquare;
+        int halfMoveClock;
+        uint64_t positionKey;
+    };
 
-    chessPiece(const chessPiece& other) : color(other.color), type(other.type) {}
+    // Fixed capacity move list that lives on the caller's stack, move generation never touches the heap.
+    // The storage is raw so a new list does not zero MAX_MOVES moves, only the pushed ones are ever read
+    struct MoveList {
+        static const int MAX_MOVES = 256; // more than the legal moves of any reachable position
 
-    // Constructor for chessPiece
-    chessPiece(short color = 0, short type = 0) : color(color), type(type) {}
-};
+        alignas(Move) unsigned char storage[MAX_MOVES * sizeof(Move)];
+        int count = 0;
 
-    // Represents a move in chess (e.g., "e2e4")
-    struct Move {
-        short from; // Starting square (0-63)
-        short to;   // Ending square (0-63)
-        short promotion; // Promotion piece type (0-6 for none, knight, bishop, rook, queen, king)
-        short capture; // Capture piece type (0-6 for none, knight, bishop, rook, queen, king)
-        short color; // Color of the piece making the move (1 for white, 2 for black)
-        short piece; // Piece type (1-6 for pawn to king)
-        short moveType; // Type of move (0 for normal, 1 for Kindgside castling, 2 for Queenside castling, 3 for en passant, 4 for pawn double move)
-
-        // Default constructor for a null move
-        Move() 
-            : from(-1), to(-1), promotion(0), capture(0), color(0), piece(0), moveType(0) {}
+        void push_back(const Move &move) { new (&moves()[count++]) Move(move); }
+        void clear() { count = 0; }
 
-        Move(short from, short to, short promotion, short capture, short color, short piece, short moveType) :
-            from(from), to(to), promotion(promotion), capture(capture), color(color), piece(piece), moveType(moveType) {}
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        Move &operator[](size_t index) { return moves()[index]; }
+        const Move &operator[](size_t index) const { return moves()[index]; }
+        const Move &at(size_t index) const { return moves()[index]; }
+        const Move &back() const { return moves()[count - 1]; }
+
+        Move *begin() { return moves(); }
+        Move *end() { return moves() + count; }
+        const Move *begin() const { return moves(); }
+        const Move *end() const { return moves() + count; }
+
+    private:
+        Move *moves() { return reinterpret_cast<Move *>(storage); }
+        const Move *moves() const { return reinterpret_cast<const Move *>(storage); }
+    };
+
+    // Check and pin information for the side to move, computed once per position
+    struct legalMoveMasks {
+        short kingSquare = -1;
+        uint64_t checkers = 0;          // opponent pieces giving check
+        uint64_t pinned = 0;            // own pieces pinned to the king
+        uint64_t evasionMask = ~0ULL;   // squares non-king moves must land on
+        uint64_t attacked = 0;          // squares attacked by the opponent, king removed from the occupancy
+    };
 
-        // Copy constructor (deep copy isn't needed here, just copying the fields)
-        Move(const Move& other)
-            : from(other.from), to(other.to), promotion(other.promotion),
-                capture(other.capture), color(other.color), piece(other.piece), moveType(other.moveType) {}
+    // Squares from which each piece type of the moving side checks the opponent king, computed once per position
+    struct checkInfo {
+        short kingSquare = -1;              // opponent king, -1 when there is none
+        uint64_t checkSquares[7] = {};      // indexed by piece type, the king can never give check itself
+        uint64_t discoveredCandidates = 0;  // own pieces that uncover a slider check when they leave the line
     };
 
     struct evalMove {
@@ -87,30 +121,39 @@ struct chessPiece
 
 };
 
-    // change to stack type TODO
-    bool whiteQCastle = true;
-    bool whiteKCastle = true;
-    bool blackQCastle = true;
-    bool blackKCastle = true;
-    int enPassantSquare = -1;
-    chessPiece internalBoard[64]; // 8x8 chess board represented as an array of pieces
+    // Piece colors, also the template arguments of the color specialised move generation
+    static const short WHITE = 1;
+    static const short BLACK = 2;
+
+    // Undo history, one record per move made. When it fills the older half is dropped, so it only reaches back
+    // as far as the search needs. ChessBot keeps the full game record
+    static const int MAX_HISTORY = 1024;
+    stateRecord history[MAX_HISTORY];
+    int historyCount = 0;
 
-    std::stack<Move> moveStack; // Stack to keep track of moves for undo functionality
-    std::stack<castleRights> castleStack; // stack to keep track of castling rights history
+    // Slider attack tables this board reads, the backend picked at load unless setSliderBackend chose another
+    const AttackTables::sliderTables *sliders = &AttackTables::getActiveTables();
 
     // Constructor
     ChessLogic();
 
-    ChessLogic(chessPiece (&board)[], std::stack<Move> moveStack, std::stack<castleRights> castleStack, 
-        bool wKC, bool wQC, bool bKC, bool bQC, int ePSq);
+    // Starts from a snapshot with an empty undo history, the cheap way to give a thread its own board
+    explicit ChessLogic(const ChessPosition &position);
+
+    // The position without the history, copying it is a single memcpy
+    const ChessPosition &getPosition() const;
+
+    // Makes this board read the tables of another slider backend, the tables of every other board stay as they are.
+    // Returns false if the CPU cannot run the backend
+    bool setSliderBackend(short backend);
 
     // Destructor
     ~ChessLogic();
 
     // Get all legal moves for the current board position
-    std::vector<Move> getLegalMoves(bool isWhite);
+    MoveList getLegalMoves(bool isWhite);
 
-    std::string printLegalMoves(const std::vector<Move> moves) const;
+    std::string printLegalMoves(const MoveList &moves) const;
 
     bool isMoveLegal(const Move &move);
 
@@ -126,9 +169,19 @@ struct chessPiece
 
     bool isInCheck(bool isWhite) const;
 
-    // Undo the last move
+    template<short color>
+    bool isInCheck() const;
+
+    // Undo the last move, null moves included
     void undoMove();
 
+    // Passes the turn without touching the board, for null move pruning. Only clears en passant and updates the key.
+    // The side to move must not be in check
+    void makeNullMove();
+
+    // Takes back the null move made last. Does nothing and returns false when the last record is not a null move
+    bool undoNullMove();
+
     Move translateMove(short fromSquare, short toSquare) const;
 
     Move translateMove(const std::string &moveStr) const;
@@ -148,8 +201,65 @@ struct chessPiece
     // Helper methods for move generation and evaluation
     bool isMovePsuedoLegal(const Move &move) const;
 
+    // Move kinds for staged generation
+    static const short ALL_MOVES = 0;
+    static const short CAPTURE_MOVES = 1; // captures, en passant and every promotion
+    static const short QUIET_MOVES = 2;   // everything else, castling included
+
+    // Emits only legal moves for color using check and pin masks, no moves are made on the board
+    void generateLegalMoves(short color, MoveList &moves) const;
+
+    // Emits the legal moves of one kind, the masks can be shared between the calls for each kind
+    void generateLegalMoves(short color, MoveList &moves, short moveKind, const legalMoveMasks &masks) const;
+
+    // Same generator with the color fixed at compile time, the short color overloads dispatch to these
+    template<short color>
+    void generateLegalMoves(MoveList &moves, short moveKind, const legalMoveMasks &masks) const;
+
+    // Tells if color has a legal move, stopping at the first one found instead of generating them all
+    bool hasAnyLegalMove(short color) const;
+
+    template<short color>
+    bool hasAnyLegalMove() const;
+
+    // Check and pin masks for color
+    legalMoveMasks getLegalMoveMasks(short color) const;
+
+    template<short color>
+    legalMoveMasks getLegalMoveMasks() const;
+
+    // Tells if a move from another position (hash move, killer) is legal here without generating the move list
+    bool isLegalInPosition(const Move &move, const legalMoveMasks &masks) const;
+
+    // Squares attacked by color for the given occupancy
+    uint64_t getAttackedSquares(short color, uint64_t occupied) const;
+
+    // Pieces of both colors attacking square for the given occupancy
+    uint64_t attackersTo(short square, uint64_t occupied) const;
+
+    bool isSquareAttacked(short square, short byColor, uint64_t occupied) const;
+
+    // Check squares and discovered check candidates for moves of color
+    checkInfo getCheckInfo(short color) const;
+
+    // Tells if a legal move checks the opponent king, without making it
+    bool givesCheck(const Move &move, const checkInfo &info) const;
+
+    bool givesCheck(const Move &move) const;
+
+    // Piece values used by the static exchange evaluation, the same scale as MaterialEvalStrategy
+    static constexpr int SEE_VALUES[7] = {0, 100, 320, 330, 500, 900, 20000};
+
+    // Static exchange evaluation: material won by the side making the move once both sides have made every
+    // profitable capture on its target square, least valuable attacker first and x-rays included. Pins are ignored
+    int see(const Move &move) const;
+
+    // see(move) >= threshold without building the whole swap list, it stops as soon as the outcome is known
+    bool seeGE(const Move &move, int threshold) const;
+
     uint64_t getColorBitBoard(short color) const;
     uint64_t getPieceBitBoard(short color, short piece) const;
+    uint64_t getOccupiedBitBoard() const;
     uint64_t getPawnMoveBitBoard(short color) const;
     uint64_t getKnightMoveBitBoard(short color) const;
     uint64_t getBishopMoveBitBoard(short color) const;
@@ -163,14 +273,29 @@ struct chessPiece
 
     std::string printBoard() const;
 
+    // Recomputes the key from scratch, positionKey always equals hashPosition(whiteToMove)
     uint64_t hashPosition(bool isWhiteTurn) const;
 
-    void initializeZobrist();
+    uint64_t getPositionKey() const;
 
-    std::unordered_map<uint64_t, int> transpositionTable;
+    // Sets the side to move and rebuilds the key, needed after the board or state is edited directly
+    void setSideToMove(bool isWhite);
 
+    // The moves still in the undo history, the latest MAX_HISTORY / 2 or more once it has filled
     std::vector<Move> getMoveHistory() const;
 
+    // Times the current position occurred earlier, only looking back to the last capture or pawn move
+    int getRepetitionCount() const;
+
+    // Counts the leaf nodes of the legal move tree, the last ply is bulk counted from the move list
+    uint64_t perft(short depth);
+
+    // Same count, reusing subtree counts that other threads already stored in the hash
+    uint64_t perft(short depth, PerftHash &hash);
+
+    // Perft split by root move, for finding the move where a count goes wrong
+    std::vector<std::pair<Move, uint64_t>> divide(short depth);
+
     std::string printMoves(std::vector<Move> moves) const;
 
     std::string squareToString(short square) const;
@@ -179,12 +304,47 @@ struct chessPiece
 
 protected:
 
-private:
-    uint64_t zobristTable[64][12]; // Random values for pieces on squares
-    uint64_t zobristCastling[4];   // Random values for castling rights
-    uint64_t zobristEnPassant[8];  // Random values for en passant files
-    uint64_t zobristTurn;          // Random value for the player's turn
+    // Board edits that keep internalBoard and the bitboards in sync
+    void putPiece(short square, const chessPiece &piece);
+    void removePiece(short square);
+    void movePiece(short fromSquare, short toSquare);
+    void refreshBitBoards();
+
+    void revokeCastleRights(short square);
+
+    uint64_t castlingAndEnPassantKey() const;
+
+    // Appends the undo record of a move, real or null, with the state every move overwrites filled in
+    stateRecord &pushHistory(const Move &move);
+
+    // Moves a set of pawns one rank forward, white pawns move towards square 0
+    template<short color>
+    static uint64_t shiftForward(uint64_t bitboard) {
+        return (color == WHITE) ? (bitboard >> 8) : (bitboard << 8);
+    }
+
+    template<short color>
+    uint64_t getAttackedSquares(uint64_t occupied) const;
+
+    template<short color>
+    uint64_t getPawnMoveBitBoard() const;
+
+    template<short color>
+    uint64_t perft(short depth);
+
+    template<short color>
+    void generatePawnMoves(short moveKind, const legalMoveMasks &masks, MoveList &moves) const;
+    template<short color>
+    void addPawnMoves(uint64_t targets, short offset, const legalMoveMasks &masks, MoveList &moves) const;
+    template<short color>
+    void generateCastlingMoves(const legalMoveMasks &masks, MoveList &moves) const;
+
+    // Least valuable piece of color in attackers, 0 when there is none
+    short leastValuableAttacker(uint64_t attackers, short color, uint64_t &attackerBit) const;
 
+    bool isPinnedOffLine(short fromSquare, short toSquare, const legalMoveMasks &masks) const;
+    template<short color>
+    bool isEnPassantLegal(short fromSquare, const legalMoveMasks &masks) const;
 };
 
 
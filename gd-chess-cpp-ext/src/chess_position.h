@@ -0,0 +1,52 @@
+#ifndef CHESS_POSITION_H
+#define CHESS_POSITION_H
+
+#include <cstdint>
+#include <type_traits>
+
+// Everything that describes a position and nothing else: no undo history, no tables, no heap memory.
+// ChessLogic derives from it, so a search or perft thread can start from a copy made with one memcpy.
+struct ChessPosition {
+
+struct castleRights
+{
+    bool wKingside;
+    bool wQueenside;
+    bool bKingside;
+    bool bQueenside;
+
+    castleRights(bool wKingside = false, bool wQueenside = false, bool bKingside = false, bool bQueenside = false) :
+        wKingside(wKingside), wQueenside(wQueenside), bKingside(bKingside), bQueenside(bQueenside) {}
+};
+
+struct chessPiece
+{
+    short color; // 1 = white, 2 = black
+    short type; // 1 = pawn, 2 = knight, 3 = bishop, 4 = rook, 5 = queen, 6 = king
+
+    // Constructor for chessPiece
+    chessPiece(short color = 0, short type = 0) : color(color), type(type) {}
+};
+
+    // change to stack type TODO
+    bool whiteQCastle = true;
+    bool whiteKCastle = true;
+    bool blackQCastle = true;
+    bool blackKCastle = true;
+    int enPassantSquare = -1;
+    int halfMoveClock = 0; // plies since the last capture or pawn move
+    chessPiece internalBoard[64]; // 8x8 chess board represented as an array of pieces
+
+    // Occupancy bitboards kept in sync with internalBoard, indexed by color (1 = white, 2 = black) and piece type
+    uint64_t colorBitBoards[3];
+    uint64_t pieceBitBoards[3][7];
+    short kingSquares[3] = {-1, -1, -1}; // tracked by putPiece/removePiece, -1 when the color has no king
+
+    // Zobrist key of the current position, updated by every board edit and by makeMove/undoMove
+    uint64_t positionKey = 0;
+    bool whiteToMove = true; // flipped by makeMove/undoMove, only needed for the key
+};
+
+static_assert(std::is_trivially_copyable<ChessPosition>::value, "ChessPosition must stay memcpy copyable");
+
+#endif // CHESS_POSITION_H
@@ -97,6 +97,81 @@ extern "C" {
         }
         return 0;
     }
+
+    const char * perft(void * uci_instance, short depth) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->perft(depth);
+        }
+        return nullptr;
+    }
+
+    const char * perftThreaded(void * uci_instance, short depth, short threadCount, int hashSizeMB) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->perft(depth, threadCount, hashSizeMB);
+        }
+        return nullptr;
+    }
+
+    const char * divide(void * uci_instance, short depth) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->divide(depth);
+        }
+        return nullptr;
+    }
+
+    int see(void * uci_instance, const char * move) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->see(move);
+        }
+        return 0;
+    }
+
+    bool givesCheck(void * uci_instance, const char * move) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->givesCheck(move);
+        }
+        return false;
+    }
+
+    unsigned long long getNodeCount(void * uci_instance) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->getNodeCount();
+        }
+        return 0;
+    }
+
+    void makeNullMove(void * uci_instance) {
+        if (uci_instance) {
+            static_cast<ChessUCI *>(uci_instance)->makeNullMove();
+        }
+    }
+
+    void undoNullMove(void * uci_instance) {
+        if (uci_instance) {
+            static_cast<ChessUCI *>(uci_instance)->undoNullMove();
+        }
+    }
+
+    unsigned long long getPositionKey(void * uci_instance) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->getPositionKey();
+        }
+        return 0;
+    }
+
+    int getRepetitionCount(void * uci_instance) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->getRepetitionCount();
+        }
+        return 0;
+    }
+
+    const char * benchSliderBackends(void * uci_instance, short depth) {
+        if (uci_instance) {
+            return static_cast<ChessUCI *>(uci_instance)->benchSliderBackends(depth);
+        }
+        return nullptr;
+    }
 }
 
 ChessUCI::ChessUCI() {
@@ -176,6 +251,14 @@ void ChessUCI::setOption(const char * option, const char * value) {
             chessBot->setMoveStrategy(value);
         } else if (strcmp(option, "eval_strategy") == 0) {
             chessBot->setEvalStrategy(value);
+        } else if (strcmp(option, "quiescence") == 0) {
+            chessBot->setQuiescence(value);
+        } else if (strcmp(option, "hash") == 0) {
+            chessBot->setHashSize(atoi(value)); // in MB
+        } else if (strcmp(option, "smp") == 0) {
+            chessBot->setSmpMode(value);
+        } else if (strcmp(option, "move_ordering") == 0) {
+            chessBot->setMoveOrdering(value);
         } else {
             printf("Unknown option: %s\n", option);
         }
@@ -218,19 +301,94 @@ char ** ChessUCI::getMoveHistory() {
 
 short ChessUCI::getGameResult() {
     if (chessBot) {
-        if (chessBot->getCheckmate() == 1) {
-            return 2; // White wins
-        } else if (chessBot->getCheckmate() == 2) {
-            return 3; // Black wins
-        } else if (chessBot->isStaleMate()) {
-            return 4; // Stalemate
-        } else if (chessBot->isCheck()) {
-            return 1; // normal check
-        }
+        return chessBot->getGameResult(); // one legal move check per position, cached between polls
     }
     return 0; // Game ongoing
 }
 
+char * ChessUCI::perft(short depth) {
+    if (chessBot) {
+        static std::string perftBuffer; // static needed to keep the string alive after function returns
+        perftBuffer = chessBot->perft(depth);
+        return const_cast<char *>(perftBuffer.c_str());
+    }
+    return nullptr;
+}
+
+char * ChessUCI::perft(short depth, short threadCount, int hashSizeMB) {
+    if (chessBot) {
+        static std::string perftBuffer; // static needed to keep the string alive after function returns
+        perftBuffer = chessBot->perft(depth, threadCount, hashSizeMB);
+        return const_cast<char *>(perftBuffer.c_str());
+    }
+    return nullptr;
+}
+
+char * ChessUCI::divide(short depth) {
+    if (chessBot) {
+        static std::string divideBuffer; // static needed to keep the string alive after function returns
+        divideBuffer = chessBot->divide(depth);
+        return const_cast<char *>(divideBuffer.c_str());
+    }
+    return nullptr;
+}
+
+int ChessUCI::see(const char * move) {
+    if (chessBot) {
+        return chessBot->see(move);
+    }
+    return 0;
+}
+
+bool ChessUCI::givesCheck(const char * move) {
+    if (chessBot) {
+        return chessBot->givesCheck(move);
+    }
+    return false;
+}
+
+unsigned long long ChessUCI::getNodeCount() {
+    if (chessBot) {
+        return chessBot->getNodeCount();
+    }
+    return 0;
+}
+
+void ChessUCI::makeNullMove() {
+    if (chessBot) {
+        chessBot->applyNullMove();
+    }
+}
+
+void ChessUCI::undoNullMove() {
+    if (chessBot) {
+        chessBot->undoNullMove();
+    }
+}
+
+unsigned long long ChessUCI::getPositionKey() {
+    if (chessBot) {
+        return chessBot->getPositionKey();
+    }
+    return 0;
+}
+
+int ChessUCI::getRepetitionCount() {
+    if (chessBot) {
+        return chessBot->getRepetitionCount();
+    }
+    return 0;
+}
+
+char * ChessUCI::benchSliderBackends(short depth) {
+    if (chessBot) {
+        static std::string benchBuffer; // static needed to keep the string alive after function returns
+        benchBuffer = chessBot->benchSliderBackends(depth);
+        return const_cast<char *>(benchBuffer.c_str());
+    }
+    return nullptr;
+}
+
 void ChessUCI::freeMoveHistory(char **moveHistory) {
     if (moveHistory) {
         for (size_t i = 0; moveHistory[i] != nullptr; ++i) {
@@ -52,6 +52,28 @@ extern "C" {
 
     EXPORT_SYMBOL short getGameResult(void * uci_instance);
 
+    EXPORT_SYMBOL const char * perft(void * uci_instance, short depth);
+
+    EXPORT_SYMBOL const char * divide(void * uci_instance, short depth);
+
+    EXPORT_SYMBOL const char * perftThreaded(void * uci_instance, short depth, short threadCount, int hashSizeMB);
+
+    EXPORT_SYMBOL const char * benchSliderBackends(void * uci_instance, short depth);
+
+    EXPORT_SYMBOL int see(void * uci_instance, const char * move);
+
+    EXPORT_SYMBOL bool givesCheck(void * uci_instance, const char * move);
+
+    EXPORT_SYMBOL unsigned long long getNodeCount(void * uci_instance);
+
+    EXPORT_SYMBOL void makeNullMove(void * uci_instance);
+
+    EXPORT_SYMBOL void undoNullMove(void * uci_instance);
+
+    EXPORT_SYMBOL unsigned long long getPositionKey(void * uci_instance);
+
+    EXPORT_SYMBOL int getRepetitionCount(void * uci_instance);
+
 }
 
 class ChessUCI {
@@ -89,6 +111,37 @@ public:
     // returns 1 if a check, 2 if white wins, 3 if black wins, 4 if draw, 0 if no result
     short getGameResult();
 
+    // perft report with the node count, time and nodes per second
+    char * perft(short depth);
+
+    char * perft(short depth, short threadCount, int hashSizeMB);
+
+    // perft report preceded by the node count of every root move
+    char * divide(short depth);
+
+    // static exchange evaluation of a move for the side making it
+    int see(const char * move);
+
+    // whether a move checks the opponent king, worked out without making it
+    bool givesCheck(const char * move);
+
+    // positions searched by the last bot move
+    unsigned long long getNodeCount();
+
+    // pass the turn and take the pass back, like the null move pruning of the search
+    void makeNullMove();
+
+    void undoNullMove();
+
+    // zobrist key of the current position
+    unsigned long long getPositionKey();
+
+    // earlier occurrences of the current position since the last irreversible or null move
+    int getRepetitionCount();
+
+    // perft report for each slider attack backend
+    char * benchSliderBackends(short depth);
+
 protected:
 
     ChessBot * chessBot = nullptr;
@@ -0,0 +1,126 @@
+#include "move_picker.h"
+
+template<short color>
+MovePicker<color>::MovePicker(const ChessLogic &logic, const ChessLogic::Move &hashMove,
+    const ChessLogic::Move *killers, const historyTable *history, bool capturesOnly) : logic(logic),
+    masks(logic.getLegalMoveMasks<color>()), hashMove(hashMove), killers(), playedKillers(), history(history),
+    capturesOnly(capturesOnly) {
+    if (killers) {
+        this->killers[0] = killers[0];
+        this->killers[1] = killers[1];
+    }
+}
+
+template<short color>
+ChessLogic::Move MovePicker<color>::next() {
+    switch (stage) {
+        case HASH_MOVE:
+            stage = GENERATE_CAPTURES;
+            if (!hashMove.isNull() && hashMove.color() == color && logic.isLegalInPosition(hashMove, masks)) {
+                return hashMove;
+            }
+            hashMove = ChessLogic::Move(); // never skip a generated move because of an illegal hash move
+            // fall through
+        case GENERATE_CAPTURES:
+            logic.generateLegalMoves<color>(moves, ChessLogic::CAPTURE_MOVES, masks);
+            index = 0;
+            stage = CAPTURES;
+            // fall through
+        case CAPTURES:
+            while (index < moves.count) {
+                ChessLogic::Move move = pickBestCapture();
+                if (move == hashMove) {
+                    continue;
+                }
+                if (!logic.seeGE(move, 0)) {
+                    std::swap(moves[badCaptureCount++], moves[index - 1]); // keeps them in MVV-LVA order
+                    continue;
+                }
+                return move;
+            }
+            if (capturesOnly) {
+                stage = DONE;
+                return ChessLogic::Move();
+            }
+            stage = KILLERS;
+            index = 0;
+            // fall through
+        case KILLERS:
+            while (index < 2) {
+                const ChessLogic::Move &killer = killers[index++];
+                if (!killer.isNull() && killer != hashMove && killer.color() == color && killer.capture() == 0
+                    && killer.promotion() == 0 && logic.isLegalInPosition(killer, masks)) {
+                    playedKillers[index - 1] = killer;
+                    return killer;
+                }
+            }
+            stage = GENERATE_QUIETS;
+            // fall through
+        case GENERATE_QUIETS:
+            moves.count = badCaptureCount;
+            logic.generateLegalMoves<color>(moves, ChessLogic::QUIET_MOVES, masks);
+            if (history) {
+                sortQuiets();
+            }
+            index = badCaptureCount;
+            stage = QUIETS;
+            // fall through
+        case QUIETS:
+            while (index < moves.count) {
+                const ChessLogic::Move &move = moves[index++];
+                if (move != hashMove && !isPlayed(move)) {
+                    return move;
+                }
+            }
+            stage = BAD_CAPTURES;
+            index = 0;
+            // fall through
+        case BAD_CAPTURES:
+            if (index < badCaptureCount) {
+                return moves[index++];
+            }
+            stage = DONE;
+            // fall through
+        default:
+            return ChessLogic::Move();
+    }
+}
+
+template<short color>
+ChessLogic::Move MovePicker<color>::pickBestCapture() {
+    int best = index;
+    int bestScore = -1000;
+    for (int i = index; i < moves.count; ++i) {
+        const ChessLogic::Move &move = moves[i];
+        int score = (move.capture() + move.promotion()) * 8 - move.piece();
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    std::swap(moves[best], moves[index]);
+    return moves[index++];
+}
+
+template<short color>
+void MovePicker<color>::sortQuiets() {
+    for (int i = badCaptureCount; i < moves.count; ++i) {
+        ChessLogic::Move move = moves[i];
+        int score = history->at(move);
+        int j = i;
+        for (; j > badCaptureCount && quietScores[j - 1] < score; --j) {
+            moves[j] = moves[j - 1];
+            quietScores[j] = quietScores[j - 1];
+        }
+        moves[j] = move;
+        quietScores[j] = score;
+    }
+}
+
+template<short color>
+bool MovePicker<color>::isPlayed(const ChessLogic::Move &move) const {
+    return move == playedKillers[0] || move == playedKillers[1];
+}
+
+template class MovePicker<ChessLogic::WHITE>;
+template class MovePicker<ChessLogic::BLACK>;
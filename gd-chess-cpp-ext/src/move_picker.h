@@ -0,0 +1,108 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "chess_logic.h"
+
+// Quiet moves that caused a beta cutoff, two per ply. Each search thread owns its own table
+struct killerTable {
+    static const int MAX_PLY = 64;
+
+    ChessLogic::Move moves[MAX_PLY][2] = {};
+
+    // Keeps the newest killer first, a move already stored is not duplicated
+    void update(short ply, const ChessLogic::Move &move) {
+        if (ply < MAX_PLY && moves[ply][0] != move) {
+            moves[ply][1] = moves[ply][0];
+            moves[ply][0] = move;
+        }
+    }
+
+    const ChessLogic::Move *at(short ply) const {
+        return ply < MAX_PLY ? moves[ply] : nullptr;
+    }
+};
+
+// Butterfly history: how often a quiet move, indexed by color, from and to square, caused a beta cutoff.
+// Each search thread owns its own table
+struct historyTable {
+    static const int MAX_SCORE = 1 << 20; // every score is halved once one reaches this
+
+    int scores[3][64][64] = {};
+
+    // Deeper cutoffs prune more, so they are rewarded with the square of the remaining depth
+    void update(const ChessLogic::Move &move, short depth) {
+        int &score = scores[move.color()][move.from()][move.to()];
+        score += depth * depth;
+        if (score >= MAX_SCORE) {
+            for (auto &fromScores : scores) {
+                for (auto &toScores : fromScores) {
+                    for (int &entry : toScores) {
+                        entry /= 2;
+                    }
+                }
+            }
+        }
+    }
+
+    int at(const ChessLogic::Move &move) const {
+        return scores[move.color()][move.from()][move.to()];
+    }
+};
+
+// Hands out the legal moves of a position one at a time: hash move, captures that do not lose material by MVV-LVA,
+// killers, quiet moves by history score, then the losing captures.
+// Each stage is only generated once the previous one is used up, so a cutoff on an early move skips the rest.
+// The quiescence search stops it after the captures and promotions that do not lose material, a promotion onto a
+// square the opponent wins back is dropped with the losing captures.
+// color is the side to move, instantiated for ChessLogic::WHITE and ChessLogic::BLACK
+template<short color>
+class MovePicker {
+public:
+
+    // killers points to the two killer moves of the ply, or nullptr when there are none.
+    // Without a history table the quiet moves come in generation order
+    MovePicker(const ChessLogic &logic, const ChessLogic::Move &hashMove, const ChessLogic::Move *killers = nullptr,
+        const historyTable *history = nullptr, bool capturesOnly = false);
+
+    // Next move in stage order, the null move once every stage is exhausted
+    ChessLogic::Move next();
+
+private:
+    // stages in the order they are visited
+    static const short HASH_MOVE = 0;
+    static const short GENERATE_CAPTURES = 1;
+    static const short CAPTURES = 2;
+    static const short KILLERS = 3;
+    static const short GENERATE_QUIETS = 4;
+    static const short QUIETS = 5;
+    static const short BAD_CAPTURES = 6;
+    static const short DONE = 7;
+
+    const ChessLogic &logic;
+    ChessLogic::legalMoveMasks masks;
+
+    ChessLogic::Move hashMove;
+    ChessLogic::Move killers[2];
+    ChessLogic::Move playedKillers[2]; // killers that turned out legal and were handed out
+
+    const historyTable *history;
+
+    // losing captures are set aside at the front of the list, the quiet moves are generated after them
+    ChessLogic::MoveList moves;
+    int index = 0;
+    int badCaptureCount = 0;
+    int quietScores[ChessLogic::MoveList::MAX_MOVES];
+    short stage = HASH_MOVE;
+    bool capturesOnly;
+
+    // Removes and returns the most valuable victim, taken by the least valuable attacker
+    ChessLogic::Move pickBestCapture();
+
+    // Sorts the quiet moves by history score, highest first. Scoring them once and sorting the short list is
+    // cheaper than scanning for the best one each time, as most nodes that reach the quiet moves search them all
+    void sortQuiets();
+
+    bool isPlayed(const ChessLogic::Move &move) const;
+};
+
+#endif // MOVE_PICKER_H
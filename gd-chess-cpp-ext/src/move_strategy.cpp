@@ -0,0 +1,55 @@
+#include "move_strategy.h"
+
+void MoveStrategy::getBestMoveLazySmp(ChessLogic &logicBoard, EvaluationStrategy* evalStrategy,
+    bool isWhite, short maxDepth, short threadIndex, std::vector<ChessLogic::evalMove> &bestMove, std::mutex &mtx,
+    short &lastDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) {
+
+    ChessLogic logic(logicBoard.getPosition()); // create own copy of the board
+    short ownDepth = 0;
+
+    while (true) {
+        mtx.lock();
+        short searchDepth = nextLazySmpDepth(ownDepth, lastDepth, maxDepth, threadIndex);
+        mtx.unlock();
+        if (searchDepth == 0) {
+            break;
+        }
+
+        ChessLogic::evalMove potentialMove = getBestMove(logic, evalStrategy, isWhite, searchDepth, stopTime);
+        ownDepth = searchDepth;
+
+        mtx.lock();
+        bool published = publishSearchResult(potentialMove, searchDepth, bestMove, lastDepth, stopTime);
+        mtx.unlock();
+        if (!published) {
+            break; // Exit early if the time limit is exceeded
+        }
+    }
+}
+
+short MoveStrategy::nextLazySmpDepth(short ownDepth, short lastDepth, short maxDepth, short threadIndex) {
+    short reached = std::max(ownDepth, lastDepth);
+    if (reached >= maxDepth) {
+        return 0;
+    }
+    // the deeper iteration of an odd thread fills the table with the moves the next iteration of the others tries first
+    return std::min<short>(reached + 1 + threadIndex % 2, maxDepth);
+}
+
+bool MoveStrategy::publishSearchResult(const ChessLogic::evalMove &potentialMove, short searchDepth,
+    std::vector<ChessLogic::evalMove> &bestMove, short &lastDepth,
+    std::chrono::time_point<std::chrono::steady_clock> stopTime) {
+
+    if (std::chrono::steady_clock::now() >= stopTime) {
+        // an unfinished search is only better than nothing
+        if (lastDepth == 0 && !potentialMove.move.isNull()) {
+            bestMove.push_back(potentialMove);
+        }
+        return false;
+    }
+    if (lastDepth < searchDepth) {
+        lastDepth = searchDepth;
+        bestMove.push_back(potentialMove);
+    }
+    return true;
+}
@@ -1,10 +1,14 @@
 #ifndef MOVE_STRATEGY_H
 #define MOVE_STRATEGY_H
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <mutex>
+#include <vector>
 #include "chess_logic.h"
 #include "eval_strategy.h"
+#include "quiescence.h"
 
 class MoveStrategy {
     public:
@@ -20,6 +24,50 @@ class MoveStrategy {
         virtual void getBestMoveThreaded(ChessLogic &logicBoard, EvaluationStrategy* evalStrategy,
             bool isWhite, std::stack<short> &depthstack, std::vector<ChessLogic::evalMove> &bestMove, std::mutex &mtx, 
             short &lastDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) = 0; 
+
+        // Lazy SMP, every thread searches the whole root and they only cooperate through the transposition table.
+        // Each thread deepens on its own, starting from the deepest iteration any thread finished, and odd threads
+        // search one ply further so the threads do not all walk the same tree at the same time.
+        // The default runs getBestMove for each depth, so it fits the strategies that keep no state between calls
+        virtual void getBestMoveLazySmp(ChessLogic &logicBoard, EvaluationStrategy* evalStrategy,
+            bool isWhite, short maxDepth, short threadIndex, std::vector<ChessLogic::evalMove> &bestMove, std::mutex &mtx,
+            short &lastDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime);
+
+        // Positions visited by the searches since the last reset, summed over every search thread
+        uint64_t getNodeCount() const {
+            return nodeCount.load();
+        }
+
+        void resetNodeCount() {
+            nodeCount = 0;
+        }
+
+        // What the search does at depth 0, one of the QuiescenceSearch modes
+        void setQuiescenceMode(short mode) {
+            quiescenceMode = mode;
+        }
+
+        // Whether the searches pass their killers and history to the move picker, only the hash move and
+        // MVV-LVA order the moves without them
+        void setMoveOrdering(bool enabled) {
+            moveOrdering = enabled;
+        }
+
+    protected:
+        // The depth a Lazy SMP thread searches after finishing ownDepth, 0 when it should stop. Called under the mutex
+        static short nextLazySmpDepth(short ownDepth, short lastDepth, short maxDepth, short threadIndex);
+
+        // Publishes the iteration a search thread finished when no thread got deeper, false when the time is up.
+        // Called under the mutex
+        static bool publishSearchResult(const ChessLogic::evalMove &potentialMove, short searchDepth,
+            std::vector<ChessLogic::evalMove> &bestMove, short &lastDepth,
+            std::chrono::time_point<std::chrono::steady_clock> stopTime);
+
+        // each search thread counts into its own variable and adds it here when it finishes
+        std::atomic<uint64_t> nodeCount{0};
+
+        short quiescenceMode = QuiescenceSearch::CHECK_EVASIONS;
+        bool moveOrdering = true;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "perft_hash.h"
+
+PerftHash::PerftHash(size_t sizeMB) {
+    size_t count = 1;
+    while (count * 2 * sizeof(perftEntry) <= sizeMB * 1024 * 1024) {
+        count *= 2;
+    }
+    entries.reset(new perftEntry[count]());
+    indexMask = count - 1;
+}
+
+bool PerftHash::probe(uint64_t key, short depth, uint64_t &nodes) const {
+    const perftEntry &entry = entries[key & indexMask];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t check = entry.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || (data & 0xFF) != uint64_t(depth)) {
+        return false;
+    }
+    nodes = data >> 8;
+    return true;
+}
+
+void PerftHash::store(uint64_t key, short depth, uint64_t nodes) {
+    perftEntry &entry = entries[key & indexMask];
+    uint64_t data = (nodes << 8) | uint64_t(depth & 0xFF);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,32 @@
+#ifndef PERFT_HASH_H
+#define PERFT_HASH_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Node counts of already counted subtrees, shared by every perft thread without locks.
+// Each entry stores its key XORed with its data, so an entry torn by two threads writing at once
+// simply fails the key check instead of returning a wrong count.
+class PerftHash {
+public:
+
+    // sizeMB is rounded down to a power of two number of entries
+    explicit PerftHash(size_t sizeMB);
+
+    bool probe(uint64_t key, short depth, uint64_t &nodes) const;
+
+    void store(uint64_t key, short depth, uint64_t nodes);
+
+private:
+    struct perftEntry {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;  // node count in the high 56 bits, depth in the low 8 bits
+    };
+
+    std::unique_ptr<perftEntry[]> entries;
+    uint64_t indexMask;
+};
+
+#endif // PERFT_HASH_H
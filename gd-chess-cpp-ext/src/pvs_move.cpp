@@ -0,0 +1,312 @@
+#include "pvs_move.h"
+
+
+ChessLogic::evalMove PvsMoveStrategy::getBestMove(ChessLogic &logic, EvaluationStrategy* evalStrategy,
+    bool isWhite, short searchDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) {
+
+    searchStack stack{evalStrategy, stopTime};
+    const uint64_t rootKey = logic.getPositionKey();
+
+    // ChessBot deepens one ply at a time, so the last result is the previous iteration when it was for this position
+    bool hasPrevious = searchDepth > 1 && previousDepth == searchDepth - 1 && previousKey == rootKey;
+    ChessLogic::evalMove result = aspirationSearch(logic, isWhite, searchDepth, hasPrevious, previousScore, stack);
+    nodeCount += stack.nodes;
+
+    if (std::chrono::steady_clock::now() < stopTime) {
+        previousKey = rootKey;
+        previousDepth = searchDepth;
+        previousScore = result.score;
+    }
+    return result;
+}
+
+ChessLogic::evalMove PvsMoveStrategy::getBestMove(ChessLogic &logic, EvaluationStrategy* evalStrategy,
+    bool isWhite, short searchDepth, short /*threadCount*/, std::chrono::time_point<std::chrono::steady_clock> stopTime) {
+        return getBestMove(logic, evalStrategy, isWhite, searchDepth, stopTime);
+    }
+
+void PvsMoveStrategy::getBestMoveThreaded(ChessLogic &logicBoard, EvaluationStrategy* evalStrategy,
+    bool isWhite, std::stack<short> &depthstack, std::vector<ChessLogic::evalMove> &bestMove, std::mutex &mtx,
+    short &lastDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) {
+
+    ChessLogic logic(logicBoard.getPosition()); // create own copy of the board
+    searchStack stack{evalStrategy, stopTime};
+
+    while (true) {
+        mtx.lock();
+        if (depthstack.empty()) {
+            mtx.unlock();
+            break;
+        }
+        short searchDepth = depthstack.top();
+        depthstack.pop();
+        // the window is centred on the deepest finished result, when it is the iteration right before this one
+        bool hasPrevious = lastDepth > 0 && lastDepth == searchDepth - 1;
+        int centre = bestMove.back().score;
+        mtx.unlock();
+
+        ChessLogic::evalMove potentialMove = aspirationSearch(logic, isWhite, searchDepth, hasPrevious, centre, stack);
+
+        mtx.lock();
+        bool published = publishSearchResult(potentialMove, searchDepth, bestMove, lastDepth, stopTime);
+        mtx.unlock();
+        if (!published) {
+            break; // Exit early if the time limit is exceeded
+        }
+    }
+
+    nodeCount += stack.nodes;
+}
+
+void PvsMoveStrategy::getBestMoveLazySmp(ChessLogic &logicBoard, EvaluationStrategy* evalStrategy,
+    bool isWhite, short maxDepth, short threadIndex, std::vector<ChessLogic::evalMove> &bestMove, std::mutex &mtx,
+    short &lastDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) {
+
+    ChessLogic logic(logicBoard.getPosition()); // create own copy of the board
+    searchStack stack{evalStrategy, stopTime};
+    short ownDepth = 0;
+
+    while (true) {
+        mtx.lock();
+        short searchDepth = nextLazySmpDepth(ownDepth, lastDepth, maxDepth, threadIndex);
+        bool hasPrevious = lastDepth > 0 && lastDepth == searchDepth - 1;
+        int centre = bestMove.back().score;
+        mtx.unlock();
+        if (searchDepth == 0) {
+            break;
+        }
+
+        ChessLogic::evalMove potentialMove = aspirationSearch(logic, isWhite, searchDepth, hasPrevious, centre, stack);
+        ownDepth = searchDepth;
+
+        mtx.lock();
+        bool published = publishSearchResult(potentialMove, searchDepth, bestMove, lastDepth, stopTime);
+        mtx.unlock();
+        if (!published) {
+            break; // Exit early if the time limit is exceeded
+        }
+    }
+
+    nodeCount += stack.nodes;
+}
+
+ChessLogic::evalMove PvsMoveStrategy::aspirationSearch(ChessLogic &logic, bool isWhite, short depth, bool hasPrevious,
+    int previousScore, searchStack &stack) {
+
+    int alpha = -INFINITE_SCORE;
+    int beta = INFINITE_SCORE;
+    int delta = ASPIRATION_WINDOW;
+    const int centre = isWhite ? previousScore : -previousScore;
+    if (hasPrevious && std::abs(centre) < MATE_SCORE - MAX_PLY) {
+        alpha = centre - delta;
+        beta = centre + delta;
+    }
+
+    while (true) {
+        ChessLogic::evalMove result = isWhite ? rootSearch<ChessLogic::WHITE>(logic, alpha, beta, depth, stack)
+                                              : rootSearch<ChessLogic::BLACK>(logic, alpha, beta, depth, stack);
+
+        bool failedLow = result.score <= alpha && alpha > -INFINITE_SCORE;
+        bool failedHigh = result.score >= beta && beta < INFINITE_SCORE;
+        if (std::chrono::steady_clock::now() >= stack.stopTime || (!failedLow && !failedHigh)) {
+            result.score = isWhite ? result.score : -result.score; // white-relative like best_eval_move
+            return result;
+        }
+
+        // the score is outside the window, search again with the failed side pushed out further
+        delta *= 2;
+        if (failedLow) {
+            alpha = std::max(result.score - delta, -INFINITE_SCORE);
+        } else {
+            beta = std::min(result.score + delta, INFINITE_SCORE);
+        }
+    }
+}
+
+template<short color>
+ChessLogic::evalMove PvsMoveStrategy::rootSearch(ChessLogic &logic, int alpha, int beta, short depth, searchStack &stack) {
+    constexpr short opponentColor = (color == ChessLogic::WHITE) ? ChessLogic::BLACK : ChessLogic::WHITE;
+    ++stack.nodes;
+
+    // the previous iteration left its best move in the table, it is searched first
+    uint64_t positionKey = logic.getPositionKey();
+    ChessLogic::Move hashMove = ChessLogic::Move();
+    TranspositionTable::ttResult stored;
+    if (transpositionTable && transpositionTable->probe(positionKey, stored)) {
+        hashMove = stored.move;
+    }
+
+    const int searchedAlpha = alpha;
+    int bestScore = -INFINITE_SCORE;
+    ChessLogic::Move bestMove = ChessLogic::Move();
+    ChessLogic::Move firstMove = ChessLogic::Move();
+
+    MovePicker<color> picker(logic, hashMove, moveOrdering ? stack.killers.at(0) : nullptr,
+        moveOrdering ? &stack.history : nullptr);
+    for (ChessLogic::Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        logic.makeMove(move);
+
+        int score;
+        if (firstMove.isNull()) {
+            firstMove = move;
+            score = -principalVariationSearch<opponentColor>(logic, -beta, -alpha, depth - 1, 1, stack);
+        } else {
+            score = -principalVariationSearch<opponentColor>(logic, -alpha - 1, -alpha, depth - 1, 1, stack);
+            if (score > alpha && score < beta) {
+                score = -principalVariationSearch<opponentColor>(logic, -beta, -alpha, depth - 1, 1, stack);
+            }
+        }
+
+        logic.undoMove();
+
+        if (std::chrono::steady_clock::now() >= stack.stopTime) {
+            // the score of the interrupted move means nothing, fall back on the move ordered first
+            if (bestMove.isNull()) {
+                return ChessLogic::evalMove(searchedAlpha, firstMove);
+            }
+            return ChessLogic::evalMove(bestScore, bestMove);
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                break;
+            }
+        }
+    }
+
+    if (bestMove.isNull()) {
+        return ChessLogic::evalMove(0, ChessLogic::Move()); // Return a null move if no legal moves are available
+    }
+
+    if (transpositionTable) {
+        short bound = TranspositionTable::EXACT_BOUND;
+        if (bestScore <= searchedAlpha) {
+            bound = TranspositionTable::UPPER_BOUND;
+        } else if (bestScore >= beta) {
+            bound = TranspositionTable::LOWER_BOUND;
+        }
+        transpositionTable->store(positionKey, bestMove, scoreToTable(bestScore, 0), depth, bound);
+    }
+    return ChessLogic::evalMove(bestScore, bestMove);
+}
+
+template<short color>
+int PvsMoveStrategy::principalVariationSearch(ChessLogic &logic, int alpha, int beta, short depth, short ply,
+    searchStack &stack) {
+        constexpr bool isWhite = (color == ChessLogic::WHITE);
+        constexpr short opponentColor = isWhite ? ChessLogic::BLACK : ChessLogic::WHITE;
+        ++stack.nodes;
+
+        // a zero window node only asks whether the score beats alpha, a wider window is on the principal variation
+        const bool pvNode = beta - alpha > 1;
+
+        uint64_t positionKey = logic.getPositionKey();
+        ChessLogic::Move hashMove = ChessLogic::Move();
+        TranspositionTable::ttResult stored;
+        if (transpositionTable && depth > 0 && transpositionTable->probe(positionKey, stored)) {
+            hashMove = stored.move;
+            // principal variation nodes always search, so the line the root plays is never cut short by the table
+            if (!pvNode && stored.depth >= depth) {
+                int score = scoreFromTable(stored.score, ply);
+                if (stored.bound == TranspositionTable::EXACT_BOUND
+                    || (stored.bound == TranspositionTable::LOWER_BOUND && score >= beta)
+                    || (stored.bound == TranspositionTable::UPPER_BOUND && score <= alpha)) {
+                    return score;
+                }
+            }
+        }
+
+        MovePicker<color> picker(logic, hashMove, moveOrdering ? stack.killers.at(ply) : nullptr,
+            moveOrdering ? &stack.history : nullptr);
+        ChessLogic::Move move = picker.next();
+
+        if (move.isNull()) {
+            if (logic.isInCheck<color>()) {
+                return -MATE_SCORE + ply; // mated, a mate found sooner scores higher for the winner
+            }
+            return 0; // stalemate
+        }
+
+        if (depth == 0) {
+            if (quiescenceMode == QuiescenceSearch::OFF) {
+                int score = stack.evalStrategy->evaluate(&logic, isWhite);
+                return isWhite ? score : -score;
+            }
+            QuiescenceSearch quiescence(stack.evalStrategy, quiescenceMode, stack.nodes);
+            return quiescence.search<color>(logic, alpha, beta, ply);
+        }
+
+        const int searchedAlpha = alpha;
+        int bestScore = -INFINITE_SCORE;
+        ChessLogic::Move bestMove = ChessLogic::Move();
+
+        for (bool firstMove = true; !move.isNull(); move = picker.next(), firstMove = false) {
+
+            logic.makeMove(move);
+
+            int score;
+            if (firstMove) {
+                score = -principalVariationSearch<opponentColor>(logic, -beta, -alpha, depth - 1, ply + 1, stack);
+            } else {
+                // prove the move is no better than the best so far, and only search it properly when it is
+                score = -principalVariationSearch<opponentColor>(logic, -alpha - 1, -alpha, depth - 1, ply + 1, stack);
+                if (score > alpha && score < beta) {
+                    score = -principalVariationSearch<opponentColor>(logic, -beta, -alpha, depth - 1, ply + 1, stack);
+                }
+            }
+
+            logic.undoMove();
+
+            if (std::chrono::steady_clock::now() >= stack.stopTime) {
+                return 0; // Exit early if the time limit is exceeded, nothing unfinished goes into the table
+            }
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = move;
+                if (score > alpha) {
+                    alpha = score;
+                    if (alpha >= beta) {
+                        if (move.capture() == 0 && move.promotion() == 0) {
+                            stack.killers.update(ply, move);
+                            stack.history.update(move, depth);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (transpositionTable) {
+            short bound = TranspositionTable::EXACT_BOUND;
+            if (bestScore <= searchedAlpha) {
+                bound = TranspositionTable::UPPER_BOUND;
+            } else if (bestScore >= beta) {
+                bound = TranspositionTable::LOWER_BOUND;
+            }
+            transpositionTable->store(positionKey, bestMove, scoreToTable(bestScore, ply), depth, bound);
+        }
+
+        return bestScore;
+    }
+
+int PvsMoveStrategy::scoreToTable(int score, short ply) {
+    if (score >= MATE_SCORE - MAX_PLY) {
+        return score + ply;
+    } else if (score <= -(MATE_SCORE - MAX_PLY)) {
+        return score - ply;
+    }
+    return score;
+}
+
+int PvsMoveStrategy::scoreFromTable(int score, short ply) {
+    if (score >= MATE_SCORE - MAX_PLY) {
+        return score - ply;
+    } else if (score <= -(MATE_SCORE - MAX_PLY)) {
+        return score + ply;
+    }
+    return score;
+}
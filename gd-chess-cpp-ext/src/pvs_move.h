@@ -0,0 +1,87 @@
+#ifndef PVS_MOVE_H
+#define PVS_MOVE_H
+
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include "chess_logic.h"
+#include "move_strategy.h"
+#include "move_picker.h"
+#include "transposition_table.h"
+
+// Negamax principal variation search. The first move of a node is searched with the full window, the others with a
+// zero window that only proves them worse, and a move that fails high is searched again with the full window.
+// Each iteration starts with an aspiration window around the score of the previous one and widens it on a fail.
+// Scores are from the side to move inside the search and white-relative in the returned evalMove, like best_eval_move
+class PvsMoveStrategy : public MoveStrategy {
+public:
+    PvsMoveStrategy() = default;
+
+    explicit PvsMoveStrategy(TranspositionTable *transpositionTable) : transpositionTable(transpositionTable) {}
+
+    ChessLogic::evalMove getBestMove(ChessLogic &logic, EvaluationStrategy* evalStrategy,
+        bool isWhite, short searchDepth,
+        std::chrono::time_point<std::chrono::steady_clock> stopTime) override;
+
+    // Splitting the root moves between threads would search each of them with a full window, so this searches on one
+    ChessLogic::evalMove getBestMove(ChessLogic &logic, EvaluationStrategy* evalStrategy,
+        bool isWhite, short searchDepth, short threadCount,
+        std::chrono::time_point<std::chrono::steady_clock> stopTime) override;
+
+    void getBestMoveThreaded(ChessLogic &logicBoard, EvaluationStrategy* evalStrategy,
+        bool isWhite, std::stack<short> &depthstack, std::vector<ChessLogic::evalMove> &bestMove, std::mutex &mtx,
+        short &lastDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) override;
+
+    // The killers and history of a thread are kept from one of its iterations to the next
+    void getBestMoveLazySmp(ChessLogic &logicBoard, EvaluationStrategy* evalStrategy,
+        bool isWhite, short maxDepth, short threadIndex, std::vector<ChessLogic::evalMove> &bestMove, std::mutex &mtx,
+        short &lastDepth, std::chrono::time_point<std::chrono::steady_clock> stopTime) override;
+
+protected:
+
+TranspositionTable *transpositionTable = nullptr;
+
+static const int INFINITE_SCORE = 1000000;
+
+// Mated at ply n scores -MATE_SCORE + n, anything within MAX_PLY of MATE_SCORE is a mate score
+static const int MATE_SCORE = 30000;
+static const int MAX_PLY = 256;
+
+static const int ASPIRATION_WINDOW = 50; // centipawns either side of the previous score, doubled on each fail
+
+// The previous iteration of getBestMove, used to centre the aspiration window of the next depth
+uint64_t previousKey = 0;
+short previousDepth = 0;
+int previousScore = 0;
+
+// What one search thread needs at every node
+struct searchStack {
+    searchStack(EvaluationStrategy *evalStrategy, std::chrono::time_point<std::chrono::steady_clock> stopTime) :
+        evalStrategy(evalStrategy), stopTime(stopTime) {}
+
+    EvaluationStrategy *evalStrategy;
+    std::chrono::time_point<std::chrono::steady_clock> stopTime;
+    killerTable killers;
+    historyTable history;
+    uint64_t nodes = 0;
+};
+
+// Searches the root with aspiration windows around previousScore, or a full window when hasPrevious is false.
+// The score of the result is white-relative
+ChessLogic::evalMove aspirationSearch(ChessLogic &logic, bool isWhite, short depth, bool hasPrevious,
+    int previousScore, searchStack &stack);
+
+template<short color>
+ChessLogic::evalMove rootSearch(ChessLogic &logic, int alpha, int beta, short depth, searchStack &stack);
+
+template<short color>
+int principalVariationSearch(ChessLogic &logic, int alpha, int beta, short depth, short ply, searchStack &stack);
+
+// Mate scores are stored relative to the node so they stay right when the position is reached at another ply
+static int scoreToTable(int score, short ply);
+static int scoreFromTable(int score, short ply);
+
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "quiescence.h"
+
+template<short color>
+int QuiescenceSearch::search(ChessLogic &logic, int alpha, int beta, short ply) {
+    constexpr bool isWhite = (color == ChessLogic::WHITE);
+    constexpr short opponentColor = isWhite ? ChessLogic::BLACK : ChessLogic::WHITE;
+
+    const bool evading = mode == CHECK_EVASIONS && logic.isInCheck<color>();
+    int staticScore = evalStrategy->evaluate(&logic, isWhite);
+    staticScore = isWhite ? staticScore : -staticScore;
+
+    if (depth >= MAX_PLY) {
+        return staticScore;
+    }
+
+    int bestScore = -MATE_SCORE + ply; // a side in check without an evasion is mated
+    if (!evading) {
+        // stand pat, the side to move does not have to capture
+        if (staticScore >= beta) {
+            return staticScore;
+        }
+        alpha = std::max(alpha, staticScore);
+        bestScore = staticScore;
+    }
+
+    // in check the masks only let the evasions through, otherwise the picker stops after the captures that do not
+    // lose material, the opponent would not let a losing exchange pay off
+    MovePicker<color> picker(logic, ChessLogic::Move(), nullptr, nullptr, !evading);
+    for (ChessLogic::Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        if (!evading) {
+            // delta pruning, winning the captured piece outright would still leave the score below alpha
+            if (move.promotion() == 0 && staticScore + ChessLogic::SEE_VALUES[move.capture()] + DELTA_MARGIN <= alpha) {
+                continue;
+            }
+        }
+
+        logic.makeMove(move);
+        ++nodes;
+        ++depth;
+        int score = -search<opponentColor>(logic, -beta, -alpha, ply + 1);
+        --depth;
+        logic.undoMove();
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    return bestScore;
+}
+
+template int QuiescenceSearch::search<ChessLogic::WHITE>(ChessLogic &logic, int alpha, int beta, short ply);
+template int QuiescenceSearch::search<ChessLogic::BLACK>(ChessLogic &logic, int alpha, int beta, short ply);
@@ -0,0 +1,46 @@
+#ifndef QUIESCENCE_H
+#define QUIESCENCE_H
+
+#include <cstdint>
+#include "chess_logic.h"
+#include "eval_strategy.h"
+#include "move_picker.h"
+
+// Search past the horizon of the main search until the position is quiet, so a capture sequence is never scored
+// half way through. Only captures and promotions are searched, and the side to move may stand pat on the static
+// evaluation instead of making any of them. Scores are from the side to move (negamax).
+class QuiescenceSearch {
+public:
+
+    // Modes, selected with the "quiescence" option
+    static const short OFF = 0;            // the main search returns the static evaluation at depth 0
+    static const short CAPTURES = 1;       // captures and promotions only, also when in check
+    static const short CHECK_EVASIONS = 2; // a side in check cannot stand pat and searches every evasion
+
+    // nodes is the search thread's node counter, each position made here adds one
+    QuiescenceSearch(EvaluationStrategy *evalStrategy, short mode, uint64_t &nodes) :
+        evalStrategy(evalStrategy), mode(mode), nodes(nodes) {}
+
+    // ply is the distance from the root, a side mated here scores -MATE_SCORE + ply
+    template<short color>
+    int search(ChessLogic &logic, int alpha, int beta, short ply);
+
+    static const int MATE_SCORE = 30000;
+
+    // bounds of the window, a white-relative minimax window is clamped to these before it is negated
+    static const int INFINITE_SCORE = 1000000;
+
+private:
+    // a capture that cannot lift the static evaluation this close to alpha is not searched
+    static const int DELTA_MARGIN = 200;
+
+    // the capture sequences end on their own, this only bounds the evasion and capture chains of odd positions
+    static const short MAX_PLY = 32;
+
+    EvaluationStrategy *evalStrategy;
+    short mode;
+    uint64_t &nodes;
+    short depth = 0;
+};
+
+#endif // QUIESCENCE_H
@@ -4,7 +4,7 @@
 ChessLogic::evalMove RandomMoveStrategy::getBestMove(ChessLogic &logic, EvaluationStrategy* evalStrategy,
                                                  bool isWhite, short searchDepth, 
                                                  std::chrono::time_point<std::chrono::steady_clock> stopTime) {
-    std::vector<ChessLogic::Move> legalMoves = logic.getLegalMoves(isWhite);
+    ChessLogic::MoveList legalMoves = logic.getLegalMoves(isWhite);
     if (legalMoves.empty()) {
         return ChessLogic::evalMove(0, ChessLogic::Move()); // Return a null move if no legal moves are available
     }
@@ -0,0 +1,88 @@
+#include "transposition_table.h"
+
+TranspositionTable::TranspositionTable(size_t sizeMB) {
+    resize(sizeMB);
+}
+
+void TranspositionTable::resize(size_t sizeMB) {
+    size_t count = 1;
+    while (count * 2 * sizeof(ttBucket) <= sizeMB * 1024 * 1024) {
+        count *= 2;
+    }
+    buckets.reset(new ttBucket[count]());
+    indexMask = count - 1;
+    this->sizeMB = sizeMB;
+    age = 0;
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i <= indexMask; ++i) {
+        for (ttEntry &entry : buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age = 0;
+}
+
+void TranspositionTable::newSearch() {
+    age = (age + 1) & 0x3F;
+}
+
+size_t TranspositionTable::getSizeMB() const {
+    return sizeMB;
+}
+
+uint64_t TranspositionTable::pack(const ChessLogic::Move &move, int score, short depth, short bound, uint8_t age) {
+    return uint64_t(move.data & 0x3FFFFFF)
+        | uint64_t((score + SCORE_OFFSET) & 0xFFFFF) << 26
+        | uint64_t(depth & 0xFF) << 46
+        | uint64_t(bound & 0x3) << 54
+        | uint64_t(age & 0x3F) << 56;
+}
+
+bool TranspositionTable::probe(uint64_t key, ttResult &result) const {
+    const ttBucket &bucket = buckets[key & indexMask];
+    for (const ttEntry &entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || data == 0) {
+            continue;
+        }
+        result.move.data = uint32_t(data & 0x3FFFFFF);
+        result.score = int((data >> 26) & 0xFFFFF) - SCORE_OFFSET;
+        result.depth = short((data >> 46) & 0xFF);
+        result.bound = short((data >> 54) & 0x3);
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, const ChessLogic::Move &move, int score, short depth, short bound) {
+    ttBucket &bucket = buckets[key & indexMask];
+
+    // the same key is always overwritten, otherwise the entry with the shallowest and oldest result makes room
+    ttEntry *replace = &bucket.entries[0];
+    int replaceWorth = 1 << 30;
+    for (ttEntry &entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key) {
+            replace = &entry;
+            break;
+        }
+        int entryAge = int((data >> 56) & 0x3F);
+        int worth = int((data >> 46) & 0xFF) - 8 * ((age - entryAge) & 0x3F);
+        if (data == 0) {
+            worth = -(1 << 30); // empty
+        }
+        if (worth < replaceWorth) {
+            replaceWorth = worth;
+            replace = &entry;
+        }
+    }
+
+    uint64_t data = pack(move, score, depth, bound, age);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
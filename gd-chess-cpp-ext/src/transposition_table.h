@@ -0,0 +1,69 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include "chess_logic.h"
+
+// Search results of earlier positions, shared by every search thread without locks.
+// Entries are grouped four to a 64 byte bucket so a probe touches a single cache line. Like PerftHash each
+// entry stores its key XORed with its data, so an entry torn by two threads writing at once fails the key check.
+// The move strategies take a pointer to the table ChessBot owns and never free it, nullptr searches without a table.
+class TranspositionTable {
+public:
+
+    // How the stored score relates to the real score of the position
+    static const short EXACT_BOUND = 1;
+    static const short LOWER_BOUND = 2; // the search failed high, the real score is at least the stored one
+    static const short UPPER_BOUND = 3; // the search failed low, the real score is at most the stored one
+
+    struct ttResult {
+        ChessLogic::Move move;
+        int score;
+        short depth;
+        short bound;
+    };
+
+    // sizeMB is rounded down to a power of two number of buckets
+    explicit TranspositionTable(size_t sizeMB);
+
+    // Reallocates the table, the stored results are lost. Not thread safe, only call it while no search is running
+    void resize(size_t sizeMB);
+
+    void clear();
+
+    // Ages out the results of earlier searches, call it once before each search
+    void newSearch();
+
+    bool probe(uint64_t key, ttResult &result) const;
+
+    // Scores have to fit in 20 bits, the move and score of a key already in the bucket are overwritten
+    void store(uint64_t key, const ChessLogic::Move &move, int score, short depth, short bound);
+
+    size_t getSizeMB() const;
+
+private:
+    struct ttEntry {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;  // bits 0-25 move, 26-45 score, 46-53 depth, 54-55 bound, 56-61 age
+    };
+
+    struct alignas(64) ttBucket {
+        static const int ENTRIES = 4;
+        ttEntry entries[ENTRIES];
+    };
+
+    static const int SCORE_OFFSET = 1 << 19; // scores are stored unsigned
+
+    std::unique_ptr<ttBucket[]> buckets;
+    uint64_t indexMask = 0;
+    size_t sizeMB = 0;
+    uint8_t age = 0; // 6 bits, wraps around
+
+    static uint64_t pack(const ChessLogic::Move &move, int score, short depth, short bound, uint8_t age);
+};
+
+#endif // TRANSPOSITION_TABLE_H
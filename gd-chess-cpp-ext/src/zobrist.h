@@ -0,0 +1,46 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Zobrist keys shared by every ChessLogic instance, generated by the compiler so they are the same in every build.
+// Pieces are indexed like ChessLogic::pieceBitBoards (color 1-2, type 1-6), the empty entries stay zero.
+struct zobristKeys {
+    uint64_t pieces[3][7][64];
+    uint64_t castling[4];   // white kingside, white queenside, black kingside, black queenside
+    uint64_t enPassant[8];  // file of the en passant square
+    uint64_t turn;          // hashed in when white is to move
+};
+
+// splitmix64, a constexpr friendly generator with well mixed output
+constexpr uint64_t zobristNext(uint64_t &state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr zobristKeys generateZobristKeys() {
+    zobristKeys keys = {};
+    uint64_t state = 123456; // fixed seed
+    for (int color = 1; color < 3; ++color) {
+        for (int type = 1; type < 7; ++type) {
+            for (int square = 0; square < 64; ++square) {
+                keys.pieces[color][type][square] = zobristNext(state);
+            }
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        keys.castling[i] = zobristNext(state);
+    }
+    for (int i = 0; i < 8; ++i) {
+        keys.enPassant[i] = zobristNext(state);
+    }
+    keys.turn = zobristNext(state);
+    return keys;
+}
+
+inline constexpr zobristKeys ZOBRIST = generateZobristKeys();
+
+#endif // ZOBRIST_H
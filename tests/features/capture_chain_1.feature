@@ -1,3 +1,30 @@
 Feature: Capture Positions - Free pieces
 
     Scenario: White to promote
+
+    Scenario: Quiescence finds the best move shallower and cheaper than a deeper plain search
+
+        Given FEN "6k1/5ppp/3p4/4r3/1n6/8/3B1PPP/Q5K1 w - - 0 1"
+        Given Eval strategy "material_eval"
+        Then Search(1) with quiescence "captures" should find "d2b4" in fewer nodes than Search(2) with "off"
+        Then Search(1) with quiescence "check_evasions" should find "a1a8" in fewer nodes than Search(3) with "off"
+
+    Scenario: Quiescence sees the pawn recapture and takes the free knight
+
+        Given FEN "6k1/5ppp/3p4/4r3/1n6/8/3B1PPP/Q5K1 w - - 0 1"
+        Given Eval strategy "material_eval"
+        Given Quiescence "captures"
+        Then Display the board
+        Then Bot(1, 5) should play "d2b4"
+
+    Scenario: Quiescence check evasions find the back rank mate behind the check
+
+        Given FEN "6k1/5ppp/3p4/4r3/1n6/8/3B1PPP/Q5K1 w - - 0 1"
+        Given Eval strategy "material_eval"
+        Given Quiescence "check_evasions"
+        Given Move strategy "pvs"
+        Then Display the board
+        Then Bot(1, 5) should play "a1a8"
+        When The move "e5e8" is played
+        Then Bot(1, 5) should play "a8e8"
+        Then The score should be "1 - 0"
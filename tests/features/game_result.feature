@@ -0,0 +1,32 @@
+Feature: Game result
+
+    Scenario: Stalemate
+
+        Given FEN "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"
+        Then The score should be "0.5 - 0.5"
+
+    Scenario: Back rank checkmate
+
+        Given FEN "3R2k1/5ppp/8/8/8/8/8/6K1 b - - 0 1"
+        Then The score should be "1 - 0"
+
+    Scenario: Check with an escape square
+
+        Given FEN "4k3/8/8/8/8/8/8/4R1K1 b - - 0 1"
+        Then The score should be "check"
+
+    Scenario: Check by a pawn that can be taken en passant
+
+        Given FEN "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1"
+        Then The score should be "check"
+
+    Scenario: Fifty move rule
+
+        Given FEN "4k3/8/8/8/8/8/8/4K2R w - - 100 80"
+        Then The score should be "0.5 - 0.5"
+
+    Scenario: A game longer than the undo history keeps every move
+
+        Given FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        When The moves "g1f3 g8f6 f3g1 f6g8" are played 300 times
+        Then The move history should hold 1200 moves starting with "g1f3"
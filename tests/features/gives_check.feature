@@ -0,0 +1,62 @@
+Feature: Gives check
+
+    Scenario: Knight landing on a check square
+
+        Given FEN "4k3/8/8/8/4N3/8/8/4K3 w - - 0 1"
+        Then The move "e4d6" should give check
+        Then The move "e4c5" should not give check
+
+    Scenario: Bishop leaving the file of its rook discovers check
+
+        Given FEN "4k3/8/8/8/4B3/8/8/K3R3 w - - 0 1"
+        Then The move "e4d5" should give check
+        Then The move "a1b1" should not give check
+
+    Scenario: Pawn pushed along the file of its rook keeps blocking
+
+        Given FEN "4k3/8/8/8/8/4P3/8/K3R3 w - - 0 1"
+        Then The move "e3e4" should not give check
+
+    Scenario: Castling kingside puts the rook on the king's file
+
+        Given FEN "5k2/8/8/8/8/8/8/4K2R w K - 0 1"
+        Then The move "e1g1" should give check
+
+    Scenario: Castling queenside puts the rook on the king's file
+
+        Given FEN "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1"
+        Then The move "e1c1" should give check
+
+    Scenario: Castling away from the king's file
+
+        Given FEN "4k3/8/8/8/8/8/8/4K2R w K - 0 1"
+        Then The move "e1g1" should not give check
+
+    Scenario: En passant removes both pawns from the rook's rank
+
+        Given FEN "8/8/8/R2pP2k/8/8/8/4K3 w - d6 0 1"
+        Then The move "e5d6" should give check
+
+    Scenario: En passant lands next to the king
+
+        Given FEN "8/2k5/8/3pP3/8/8/8/4K3 w - d6 0 1"
+        Then The move "e5d6" should give check
+
+    Scenario: Knight promotion checks directly where the queen would not
+
+        Given FEN "8/4P3/3k4/8/8/8/8/K7 w - - 0 1"
+        Then The move "e7e8n" should give check
+        Then The move "e7e8q" should not give check
+
+    Scenario: Promoted slider sees back down the file the pawn left
+
+        Given FEN "8/4P3/8/8/8/8/4k3/K7 w - - 0 1"
+        Then The move "e7e8q" should give check
+        Then The move "e7e8r" should give check
+        Then The move "e7e8b" should not give check
+
+    Scenario: Capturing promotion sees back through the square the pawn left
+
+        Given FEN "2r5/3P4/8/5k2/8/8/8/K7 w - - 0 1"
+        Then The move "d7c8q" should give check
+        Then The move "d7c8r" should not give check
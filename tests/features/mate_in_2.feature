@@ -19,3 +19,14 @@ Feature: Mate in two
         When The move "f5c8" is played
         Then Bot(5, 7) should play "a6a8"
         Then The score should be "1 - 0"
+
+    Scenario: Daily Puzzle trip to the light squares with a small hash
+
+        Given FEN "1k1r3r/2p1qppp/1pB2b2/p1pP1b2/4p3/4P2P/PPP3P1/1K1R1Q1R w - - 0 1"
+        Given Eval strategy "mat_pos_eval"
+        Given Hash size 1 MB
+        Then Display the board
+        Then Bot(5, 7) should play "f1a6" using: (4) threads
+        When The move "f5c8" is played
+        Then Bot(5, 7) should play "a6a8" using: (4) threads
+        Then The score should be "1 - 0"
@@ -0,0 +1,45 @@
+Feature: Null move
+
+    Scenario: A null move clears en passant and taking it back restores the position
+
+        Given FEN "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3"
+        When A null move is played
+        Then The FEN should be "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 1 3"
+        Then The position key should match the FEN
+        When The null move is taken back
+        Then The FEN should be "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3"
+        Then The position key should match the FEN
+
+    Scenario: Shuffling knights repeats the position
+
+        Given FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        When The move "g1f3" is played
+        When The move "g8f6" is played
+        When The move "f3g1" is played
+        When The move "f6g8" is played
+        Then The repetition count should be 1
+
+    Scenario: A repetition is not counted across a null move
+
+        Given FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        When The move "g1f3" is played
+        When A null move is played
+        When The move "f3g1" is played
+        When A null move is played
+        Then The FEN should be "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 4 3"
+        Then The repetition count should be 0
+
+    Scenario: Taking back a null move on a fresh board does nothing
+
+        Given FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        When The null move is taken back
+        Then The FEN should be "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        Then The position key should match the FEN
+
+    Scenario: Taking back a null move after a real move leaves the move in place
+
+        Given FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        When The move "e2e4" is played
+        When The null move is taken back
+        Then The FEN should be "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1"
+        Then The position key should match the FEN
@@ -0,0 +1,40 @@
+Feature: Perft
+
+    Scenario: Starting position
+
+        Given FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        Then Perft(1) should count 20 nodes
+        Then Perft(4) should count 197281 nodes
+        Then Divide(3) should count 440 nodes for "g1f3"
+
+    Scenario: Kiwipete castling, promotions and en passant
+
+        Given FEN "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+        Then Perft(3) should count 97862 nodes
+        Then Perft(3) should count 97862 nodes with every slider backend
+
+    Scenario: Pinned pawns and en passant discovered check
+
+        Given FEN "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+        Then Perft(5) should count 674624 nodes
+
+    Scenario: Promotions with checks
+
+        Given FEN "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"
+        Then Perft(4) should count 422333 nodes
+
+    Scenario: Underpromotion to give check
+
+        Given FEN "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+        Then Perft(3) should count 62379 nodes
+
+    Scenario: Threaded perft matches the single threaded count
+
+        Given FEN "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+        Then Perft(4) should count 4085603 nodes using: (4) threads and 0 MB hash
+        Then Perft(4) should count 4085603 nodes using: (4) threads and 16 MB hash
+
+    Scenario: Threaded perft with the perft hash on a deep endgame tree
+
+        Given FEN "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+        Then Perft(6) should count 11030083 nodes using: (4) threads and 16 MB hash
@@ -0,0 +1,41 @@
+Feature: Principal variation search
+
+    Scenario: PVS finds the mate in two
+
+        Given FEN "1k1r3r/2p1qppp/1pB2b2/p1pP1b2/4p3/4P2P/PPP3P1/1K1R1Q1R w - - 0 1"
+        Given Eval strategy "mat_pos_eval"
+        Given Move strategy "pvs"
+        Then Display the board
+        Then Bot(5, 7) should play "f1a6"
+        When The move "f5c8" is played
+        Then Bot(5, 7) should play "a6a8"
+        Then The score should be "1 - 0"
+
+    Scenario Outline: Threaded PVS finds the back rank mate in three with <mode> SMP
+
+        Given FEN "1k6/ppp5/8/8/4r3/3r4/8/K6R w - - 0 1"
+        Given Eval strategy "material_eval"
+        Given Move strategy "pvs"
+        Given SMP mode "<mode>"
+        Then Display the board
+        Then Bot(7, 3) should play "h1h8" using: (4) threads
+        When The move "e4e8" is played
+        Then Bot(7, 3) should play "h8e8" using: (4) threads
+        When The move "d3d8" is played
+        Then Bot(7, 3) should play "e8d8" using: (4) threads
+        Then The score should be "1 - 0"
+
+        Examples:
+            | mode        |
+            | lazy        |
+            | depth_split |
+
+    Scenario: PVS searches fewer nodes than the minimax at equal depth
+
+        Given FEN "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+        Then Search(5) with "pvs" should visit fewer nodes than "best_eval_move"
+
+    Scenario: Killers and history cut the quiet opening moves off sooner
+
+        Given FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+        Then Search(5) with move ordering "on" should visit fewer nodes than "off" with "pvs"
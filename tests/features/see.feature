@@ -0,0 +1,36 @@
+Feature: Static exchange evaluation
+
+    Scenario: Rook takes an undefended pawn
+
+        Given FEN "1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1"
+        Then SEE of "e1e5" should be 100
+
+    Scenario: Knight takes a pawn defended through an x-ray battery
+
+        Given FEN "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1"
+        Then SEE of "d3e5" should be -220
+
+    Scenario: Queen takes a pawn defended by a pawn
+
+        Given FEN "4k3/8/2p5/3p4/4Q3/8/8/4K3 w - - 0 1"
+        Then SEE of "e4d5" should be -800
+
+    Scenario: Doubled rooks against doubled rooks
+
+        Given FEN "3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1"
+        Then SEE of "d2d5" should be -400
+
+    Scenario: Queen leading the rooks behind it
+
+        Given FEN "3rk3/3r4/8/3p4/8/3Q4/3R4/3RK3 w - - 0 1"
+        Then SEE of "d3d5" should be -300
+
+    Scenario: Pawn takes a pawn and the king cannot recapture into the bishop x-ray
+
+        Given FEN "8/8/8/2k5/3p4/4P3/5B2/4K3 w - - 0 1"
+        Then SEE of "e3d4" should be 100
+
+    Scenario: Black takes an undefended rook
+
+        Given FEN "4k3/8/8/3p4/3R4/8/8/3rK3 b - - 0 1"
+        Then SEE of "d1d4" should be 500
@@ -89,11 +89,10 @@ class GDChessBot:
         self.library.getMoveHistoryPtr.restype = ctypes.POINTER(ctypes.c_char_p)
         move_history = self.library.getMoveHistoryPtr(self.uci_instance)
         moves = []
-        for i in range(100):
-            move = move_history[i]
-            if not move:
-                break
-            moves.append(move.decode())
+        i = 0
+        while move_history[i]: # the array ends with a null pointer
+            moves.append(move_history[i].decode())
+            i += 1
         self.library.freeMoveHistoryPtr(self.uci_instance, move_history)
         return moves
 
@@ -116,6 +115,103 @@ class GDChessBot:
             assert False, f"unknown game result {result}"
         
 
+    def perft(self, depth: int) -> int:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.perft.argtypes = [ctypes.POINTER(ChessUCI), ctypes.c_short]
+        self.library.perft.restype = ctypes.c_char_p
+        report = self.library.perft(self.uci_instance, depth).decode()
+        print(report)
+        return self.parse_perft_nodes(report)
+
+    def perft_threaded(self, depth: int, thread_cnt: int, hash_mb: int) -> int:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.perftThreaded.argtypes = [ctypes.POINTER(ChessUCI), ctypes.c_short, ctypes.c_short, ctypes.c_int]
+        self.library.perftThreaded.restype = ctypes.c_char_p
+        report = self.library.perftThreaded(self.uci_instance, depth, thread_cnt, hash_mb).decode()
+        print(report)
+        return self.parse_perft_nodes(report)
+
+    def divide(self, depth: int) -> dict:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.divide.argtypes = [ctypes.POINTER(ChessUCI), ctypes.c_short]
+        self.library.divide.restype = ctypes.c_char_p
+        report = self.library.divide(self.uci_instance, depth).decode()
+        print(report)
+        counts = {}
+        for line in report.splitlines():
+            move, sep, nodes = line.partition(": ")
+            if sep and len(move) in (4, 5):
+                counts[move] = int(nodes)
+        return counts
+
+    def see(self, move: str) -> int:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.see.argtypes = [ctypes.POINTER(ChessUCI), ctypes.c_char_p]
+        self.library.see.restype = ctypes.c_int
+        return self.library.see(self.uci_instance, move.encode())
+
+    def gives_check(self, move: str) -> bool:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.givesCheck.argtypes = [ctypes.POINTER(ChessUCI), ctypes.c_char_p]
+        self.library.givesCheck.restype = ctypes.c_bool
+        return self.library.givesCheck(self.uci_instance, move.encode())
+
+    def get_node_count(self) -> int:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.getNodeCount.argtypes = [ctypes.POINTER(ChessUCI)]
+        self.library.getNodeCount.restype = ctypes.c_ulonglong
+        return self.library.getNodeCount(self.uci_instance)
+
+    def make_null_move(self):
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.makeNullMove.argtypes = [ctypes.POINTER(ChessUCI)]
+        self.library.makeNullMove(self.uci_instance)
+
+    def undo_null_move(self):
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.undoNullMove.argtypes = [ctypes.POINTER(ChessUCI)]
+        self.library.undoNullMove(self.uci_instance)
+
+    def get_position_key(self) -> int:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.getPositionKey.argtypes = [ctypes.POINTER(ChessUCI)]
+        self.library.getPositionKey.restype = ctypes.c_ulonglong
+        return self.library.getPositionKey(self.uci_instance)
+
+    def get_repetition_count(self) -> int:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.getRepetitionCount.argtypes = [ctypes.POINTER(ChessUCI)]
+        self.library.getRepetitionCount.restype = ctypes.c_int
+        return self.library.getRepetitionCount(self.uci_instance)
+
+    def bench_slider_backends(self, depth: int) -> list:
+        if not self.uci_instance:
+            raise RuntimeError("UCI instance not created.")
+        self.library.benchSliderBackends.argtypes = [ctypes.POINTER(ChessUCI), ctypes.c_short]
+        self.library.benchSliderBackends.restype = ctypes.c_char_p
+        report = self.library.benchSliderBackends(self.uci_instance, depth).decode()
+        print(report)
+        # one node count per backend the CPU supports
+        return [self.parse_perft_nodes(section) for section in report.split("Slider backend: ")
+                if "Nodes searched: " in section]
+
+    @staticmethod
+    def parse_perft_nodes(report: str) -> int:
+        for line in report.splitlines():
+            if line.startswith("Nodes searched: "):
+                return int(line[len("Nodes searched: "):])
+        assert False, f"no node count in perft report {report}"
+
     def __del__(self):
         if self.uci_instance:
             self.library.destroyChessUci(self.uci_instance)
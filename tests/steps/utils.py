@@ -18,6 +18,34 @@ def given_eval_strategy(context, strategy):
     """
     context.bot.set_option('eval_strategy', strategy)
 
+@given('Move strategy "{strategy}"')
+def given_move_strategy(context, strategy):
+    """
+    Set the Chessbot search to another move strategy
+    """
+    context.bot.set_option('move_strategy', strategy)
+
+@given('Quiescence "{mode}"')
+def given_quiescence(context, mode):
+    """
+    Set what the search does at its horizon: "off", "captures" or "check_evasions"
+    """
+    context.bot.set_option('quiescence', mode)
+
+@given('Hash size {size} MB')
+def given_hash_size(context, size):
+    """
+    Resize the transposition table the search shares between moves.
+    """
+    context.bot.set_option('hash', size)
+
+@given('SMP mode "{mode}"')
+def given_smp_mode(context, mode):
+    """
+    Set how the threaded search shares the work: "depth_split" or "lazy"
+    """
+    context.bot.set_option('smp', mode)
+
 @then('Display the board')
 def then_display_board(context):
     """
@@ -72,7 +100,144 @@ def move_is_played(context, move):
     print(context.board)
     print(f'move: {move}')
 
+@when('A null move is played')
+def null_move_is_played(context):
+    context.bot.make_null_move()
+    print(f'null move, FEN: {context.bot.export_fen()}')
+
+@when('The null move is taken back')
+def null_move_is_taken_back(context):
+    context.bot.undo_null_move()
+    print(f'null move taken back, FEN: {context.bot.export_fen()}')
+
+@then('The FEN should be "{fen}"')
+def compare_fen(context, fen):
+    exported = context.bot.export_fen()
+    assert exported == fen, f"Expected FEN: {fen}, but got: {exported}"
+
+@then('The position key should match the FEN')
+def compare_position_key(context):
+    """
+    Verify that the incrementally kept key equals the key of the same position set up from scratch.
+    """
+    reference = GDChessBot()
+    reference.input_fen(context.bot.export_fen())
+    key = context.bot.get_position_key()
+    expected = reference.get_position_key()
+    assert key == expected, f"Expected position key: {expected:#x}, but got: {key:#x}"
+
+@then('The repetition count should be {count}')
+def compare_repetition_count(context, count):
+    repetitions = context.bot.get_repetition_count()
+    assert repetitions == int(count), f"Expected {count} earlier occurrences, but got: {repetitions}"
+
+@when('The moves "{moves}" are played {times} times')
+def moves_are_played_repeatedly(context, moves, times):
+    for _ in range(int(times)):
+        for move in moves.split():
+            context.bot.make_move(move)
+
+@then('The move history should hold {count} moves starting with "{move}"')
+def compare_move_history(context, count, move):
+    history = context.bot.get_move_history()
+    assert len(history) == int(count), f"Expected {count} moves in the history, but got: {len(history)}"
+    assert history[0] == move, f"Expected the history to start with {move}, but got: {history[0]}"
+
 @then('The score should be "{score}"')
 def compare_score(context, score):
     game_result = context.bot.get_game_result()
-    assert game_result == score, f"unexpected game result is: {game_result}"
\ No newline at end of file
+    assert game_result == score, f"unexpected game result is: {game_result}"
+
+@then('Perft({depth}) should count {nodes} nodes')
+def perft_nodes(context, depth, nodes):
+    """
+    Verify the number of leaf nodes of the legal move tree.
+    """
+    perft_nodes = context.bot.perft(int(depth))
+    assert perft_nodes == int(nodes), f"Expected {nodes} nodes, but got: {perft_nodes}"
+
+@then('Perft({depth}) should count {nodes} nodes using: ({threads}) threads and {hash_mb} MB hash')
+def threaded_perft_nodes(context, depth, nodes, threads, hash_mb):
+    """
+    Verify that the parallel perft counts the same leaf nodes as the single threaded one.
+    """
+    perft_nodes = context.bot.perft_threaded(int(depth), int(threads), int(hash_mb))
+    assert perft_nodes == int(nodes), f"Expected {nodes} nodes, but got: {perft_nodes}"
+
+@then('Perft({depth}) should count {nodes} nodes with every slider backend')
+def slider_backend_perft_nodes(context, depth, nodes):
+    """
+    Verify that the magic and PEXT slider attacks give the same perft count.
+    """
+    backend_nodes = context.bot.bench_slider_backends(int(depth))
+    assert backend_nodes, "No slider backend reported a node count"
+    assert all(n == int(nodes) for n in backend_nodes), f"Expected {nodes} nodes, but got: {backend_nodes}"
+
+@then('SEE of "{move}" should be {value}')
+def static_exchange(context, move, value):
+    """
+    Verify the material the side to move wins or loses by the exchange a capture starts.
+    """
+    see_value = context.bot.see(move)
+    assert see_value == int(value), f"Expected SEE {value} for {move}, but got: {see_value}"
+
+@then('The move "{move}" should give check')
+def move_gives_check(context, move):
+    """
+    Verify that a move is known to check the opponent king before it is made.
+    """
+    assert context.bot.gives_check(move), f"Expected {move} to give check"
+
+@then('The move "{move}" should not give check')
+def move_gives_no_check(context, move):
+    assert not context.bot.gives_check(move), f"Expected {move} not to give check"
+
+@then('Divide({depth}) should count {nodes} nodes for "{move}"')
+def divide_nodes(context, depth, nodes, move):
+    """
+    Verify the number of leaf nodes below a single root move.
+    """
+    counts = context.bot.divide(int(depth))
+    assert counts.get(move) == int(nodes), f"Expected {nodes} nodes after {move}, but got: {counts.get(move)}"
+
+@then('Search({depth}) with quiescence "{mode}" should find "{move}" in fewer nodes than Search({other_depth}) with "{other}"')
+def compare_quiescence_nodes(context, depth, mode, move, other_depth, other):
+    """
+    Verify that a quiescence mode finds at a shallow depth the move another mode needs a deeper search for, and gets there in fewer nodes.
+    """
+    node_counts = {}
+    for name, search_depth in ((mode, depth), (other, other_depth)):
+        context.bot.set_option('quiescence', name)
+        bot_move = context.bot.get_bot_move(int(search_depth), 600_000)
+        node_counts[name] = context.bot.get_node_count()
+        assert bot_move == move, f"Expected Search({search_depth}) with {name} to play {move}, but got: {bot_move}"
+    print(f"Searched nodes: {node_counts}")
+    assert node_counts[mode] < node_counts[other], f"Expected {mode} to search fewer nodes, but got: {node_counts}"
+
+@then('Search({depth}) with "{strategy}" should visit fewer nodes than "{other}"')
+def compare_search_nodes(context, depth, strategy, other):
+    """
+    Verify that one move strategy needs fewer positions than another to search the same depth.
+    """
+    node_counts = {}
+    for name in (strategy, other):
+        context.bot.set_option('move_strategy', name)
+        context.bot.get_bot_move(int(depth), 600_000)
+        node_counts[name] = context.bot.get_node_count()
+    print(f"Searched nodes: {node_counts}")
+    assert node_counts[strategy] < node_counts[other], f"Expected {strategy} to search fewer nodes, but got: {node_counts}"
+
+@then('Search({depth}) with move ordering "{mode}" should visit fewer nodes than "{other}" with "{strategy}"')
+def compare_move_ordering_nodes(context, depth, mode, other, strategy):
+    """
+    Verify that the killers and history let the search cut off sooner than the hash move and MVV-LVA alone.
+    Setting the strategy clears the hash table, so the second search does not start from the first one's results.
+    """
+    node_counts = {}
+    for name in (mode, other):
+        context.bot.set_option('move_strategy', strategy)
+        context.bot.set_option('move_ordering', name)
+        context.bot.get_bot_move(int(depth), 600_000)
+        node_counts[name] = context.bot.get_node_count()
+    print(f"Searched nodes: {node_counts}")
+    assert node_counts[mode] < node_counts[other], f"Expected {mode} to search fewer nodes, but got: {node_counts}"